@@ -1,4 +1,6 @@
 #include "bots.h"
+#include <charconv>
+#include <chrono>
 
 namespace bots {
 
@@ -12,269 +14,456 @@ namespace bots {
 
 		return &bot_definitions[static_cast<int>(bot_type)];
 	}
+	void apply_bot_definition_to_agent(Agent &agent, const BotDefinition &bot_def) {
+
+		agent.agent_scale = bot_def.agent_scale;
+		agent.team = bot_def.team;
+		agent.collidable = bot_def.collidable;
+		agent.hitboxes_active = bot_def.hitboxes_active;
+		agent.show_hp_bar = bot_def.show_hp_bar;
+		agent.show_name = bot_def.show_name;
+
+		// Recycled agents usually respawn as the same type, skip reassigning the string then.
+		if (agent.username != bot_def.name) {
+			agent.username = bot_def.name;
+		}
+
+		BattleState &battle_state = agent.battle_state;
+		battle_state.rotate_node_with_pitch = bot_def.rotate_node_with_pitch;
+		battle_state.invulnerable = bot_def.invulnerable;
+	}
+	void apply_bot_definition_to_bot_state(BotState &bot_state, const BotDefinition &bot_def) {
+
+		bot_state.difficulty_type = bot_def.difficulty_type;
+		bot_state.interactable = bot_def.interact_points.size();
+
+		Movement &movement = bot_state.movement;
+		movement.acceleration_multiplier = bot_def.acceleration_multiplier;
+		movement.deceleration_multiplier = bot_def.deceleration_multiplier;
+		movement.rotation_speed = bot_def.rotation_speed;
+		movement.snap_to_navmesh = bot_def.snap_to_navmesh;
+		movement.rotate_with_steering = bot_def.rotate_with_steering;
+		movement.flying = bot_def.flying;
+		movement.avoidance_mode = bot_def.avoidance_mode;
+
+		// Set effect multipliers //
+		for (int i = 0; i < bot_def.effect_multipliers.size(); i++) {
+			movement.effect_multipliers[i] = bot_def.effect_multipliers[i];
+		}
+	}
+	void roll_bot_definition_ranges(Agent &agent, const BotDefinition &bot_def) {
+
+		double range_based_health_addition = MAX(0, bot_rand(bot_def.max_hp - bot_def.min_hp));
+
+		BattleState &battle_state = agent.battle_state;
+		battle_state.hp = bot_def.min_hp + range_based_health_addition;
+		battle_state.set_starting_max_hp(battle_state.hp);
+
+		Movement &movement = agent.bot_state.movement;
+		movement.max_speed = bot_def.min_speed + bot_rand(bot_def.max_speed - bot_def.min_speed);
+		movement.effective_max_speed = movement.max_speed;
+	}
 	bool apply_bot_definition(Agent &agent) {
 		SERVER_AND_CLIENT_SIDE;
 
 		BotDefinition *bot_def = bots::get_bot_definition(agent.bot_state.type);
 		if (!bot_def) return false;
 
-		agent.agent_scale = bot_def->agent_scale;
-		agent.team = bot_def->team;
-		agent.username = bot_def->name;
-		agent.collidable = bot_def->collidable;
-		agent.hitboxes_active = bot_def->hitboxes_active;
-		agent.show_hp_bar = bot_def->show_hp_bar;
-		agent.show_name = bot_def->show_name;
+		apply_bot_definition_to_agent(agent, *bot_def);
+		roll_bot_definition_ranges(agent, *bot_def);
+		apply_bot_definition_to_bot_state(agent.bot_state, *bot_def);
 
-		double range_based_health_addition = MAX(0, randomizer.rand(bot_def->max_hp - bot_def->min_hp));
+		return true;
+	}
+	// <---- Bot definition parsing ----> //
+	// Lines are tokenized in place as string_views and keys are dispatched thru a perfect hash table
+	// that is generated at compile time, so parsing does not allocate per line or compare against every key.
+
+	struct _ParsedLine {
+		std::string_view key;
+		std::string_view value;		// First token after the key.
+		std::string_view value2;	// Second token after the key, or value if there is none.
+		std::string_view rest;		// Everything after the key, used by multi token values (name, ui_text).
+	};
+	enum _ParseContainerType {
+		Container_None = 0,
+		Container_Interacting = 1,
+	};
+	struct _ParseContext {
+		BotDefinition *bot = nullptr;
+		InteractablePoint *interact_point = nullptr;
+		_ParseContainerType parse_type = Container_None;
+	};
+	typedef void (*_KeySetter)(_ParseContext &ctx, const _ParsedLine &line);
+	struct _KeyEntry {
+		std::string_view key;
+		_KeySetter set;
+	};
+
+	bool _is_parse_whitespace(char c) {
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+	std::string_view _trim_view(std::string_view str) {
+		while (!str.empty() && _is_parse_whitespace(str.front())) { str.remove_prefix(1); }
+		while (!str.empty() && _is_parse_whitespace(str.back())) { str.remove_suffix(1); }
+		return str;
+	}
+	// Returns the next whitespace separated token and advances str past it.
+	std::string_view _next_token(std::string_view &str) {
+		size_t start = 0;
+		while (start < str.size() && _is_parse_whitespace(str[start])) { start++; }
 
-		BattleState &battle_state = agent.battle_state;
-		battle_state.hp = bot_def->min_hp + range_based_health_addition;
-		battle_state.set_starting_max_hp(battle_state.hp);
-		battle_state.rotate_node_with_pitch = bot_def->rotate_node_with_pitch;
-		battle_state.invulnerable = bot_def->invulnerable;
+		size_t end = start;
+		while (end < str.size() && !_is_parse_whitespace(str[end])) { end++; }
 
-		BotState &bot_state = agent.bot_state;
-		bot_state.difficulty_type = bot_def->difficulty_type;
-		bot_state.interactable = bot_def->interact_points.size();
+		std::string_view token = str.substr(start, end - start);
+		str.remove_prefix(end);
+		return token;
+	}
+	double _view_to_double(std::string_view value) {
+		double result = 0.0;
+		std::from_chars(value.data(), value.data() + value.size(), result);
+		return result;
+	}
+	int _view_to_int(std::string_view value) {
+		int result = 0;
+		std::from_chars(value.data(), value.data() + value.size(), result);
+		return result;
+	}
+	bool _view_to_bool(std::string_view value) {
+		// Short enough to stay within the small string buffer.
+		return strutil::parse_bool(std::string(value), false);
+	}
+	// Appends every token followed by a space, same as the old token by token concatenation.
+	void _append_tokens(std::string &out, std::string_view tokens) {
+		out.clear();
+		for (std::string_view token = _next_token(tokens); !token.empty(); token = _next_token(tokens)) {
+			out.append(token);
+			out.push_back(' ');
+		}
+	}
 
-		Movement &movement = bot_state.movement;
-		movement.acceleration_multiplier = bot_def->acceleration_multiplier;
-		movement.deceleration_multiplier = bot_def->deceleration_multiplier;
-		movement.max_speed = bot_def->min_speed + randomizer.rand(bot_def->max_speed - bot_def->min_speed);
-		movement.effective_max_speed = movement.max_speed;
-		movement.rotation_speed = bot_def->rotation_speed;
-		movement.snap_to_navmesh = bot_def->snap_to_navmesh;
-		movement.rotate_with_steering = bot_def->rotate_with_steering;
-		movement.flying = bot_def->flying;
+	constexpr unsigned int _parse_key_hash(std::string_view key) {
+		unsigned int hash = 2166136261u;
+		for (char c : key) {
+			hash ^= (unsigned char)c;
+			hash *= 16777619u;
+		}
+		return hash;
+	}
 
-		// Set effect multipliers //
-		for (int i = 0; i < bot_def->effect_multipliers.size(); i++) {
-			movement.effect_multipliers[i] = bot_def->effect_multipliers[i];
+	constexpr _KeyEntry BOT_DEFINITION_KEYS[] = {
+		{ "name",					 [](_ParseContext &ctx, const _ParsedLine &line) { _append_tokens(ctx.bot->name, line.rest); } },
+		{ "model",					 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->model = line.value; } },
+		{ "agent_scale",			 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->agent_scale = _view_to_double(line.value); } },
+		{ "material",				 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->material = line.value; } },
+		{ "collidable",				 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->collidable = _view_to_bool(line.value); } },
+		{ "show_hp_bar",			 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->show_hp_bar = _view_to_bool(line.value); } },
+		{ "show_name",				 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->show_name = _view_to_bool(line.value); } },
+		{ "collision_radius",		 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->agent_radius = _view_to_double(line.value); } },
+		{ "rotation_speed",			 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->rotation_speed = _view_to_double(line.value); } },
+		{ "snap_to_navmesh",		 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->snap_to_navmesh = _view_to_bool(line.value); } },
+		{ "rotate_node_with_pitch",	 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->rotate_node_with_pitch = _view_to_bool(line.value); } },
+		{ "flying",					 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->flying = _view_to_bool(line.value); } },
+		{ "max_hp",					 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->min_hp = _view_to_int(line.value); ctx.bot->max_hp = _view_to_int(line.value2); } },
+		{ "max_speed",				 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->min_speed = (int)_view_to_double(line.value); ctx.bot->max_speed = (int)_view_to_double(line.value2); } },
+		{ "acceleration_multiplier", [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->acceleration_multiplier = _view_to_double(line.value); } },
+		{ "deceleration_multiplier", [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->deceleration_multiplier = _view_to_double(line.value); } },
+		{ "team",					 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->team = MAX(_view_to_int(line.value), 0); } }, // Ensure team is not negative
+		{ "knockback_multiplier",	 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->effect_multipliers[StatusEffectType::Knockback] = _view_to_double(line.value); } },
+		{ "timestop_multiplier",	 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->effect_multipliers[StatusEffectType::TimeStop] = _view_to_double(line.value); } },
+		{ "slow_multiplier",		 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->effect_multipliers[StatusEffectType::Slow] = _view_to_double(line.value); } },
+		{ "speed_multiplier",		 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->effect_multipliers[StatusEffectType::Speed] = _view_to_double(line.value); } },
+		{ "immobilize_multiplier",	 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->effect_multipliers[StatusEffectType::Immobilize] = _view_to_double(line.value); } },
+		{ "invulnerable",			 [](_ParseContext &ctx, const _ParsedLine &line) { ctx.bot->invulnerable = _view_to_bool(line.value); } },
+		{ "avoidance_mode",			 [](_ParseContext &ctx, const _ParsedLine &line) {
+			if (line.value == "orca") {
+				ctx.bot->avoidance_mode = AvoidanceMode_Orca;
+			} else if (line.value == "density_field") {
+				ctx.bot->avoidance_mode = AvoidanceMode_DensityField;
+			} else {
+				ctx.bot->avoidance_mode = AvoidanceMode_Pairwise;
+			}
+		} },
+		{ "difficulty_type",		 [](_ParseContext &ctx, const _ParsedLine &line) {
+			if (line.value == "heavy") {
+				ctx.bot->difficulty_type = DifficultyType_Heavy;
+			} else if (line.value == "elite") {
+				ctx.bot->difficulty_type = DifficultyType_Elite;
+			} else if (line.value == "boss") {
+				ctx.bot->difficulty_type = DifficultyType_Boss;
+			}
+		} },
+		{ "interactpoint",			 [](_ParseContext &ctx, const _ParsedLine &line) {
+			ctx.bot->interact_points.emplace_back();
+#ifdef PRIVATE_BUILD
+			ctx.bot->interact_points.back().debug_parsed_joint_name = line.value;
+#endif
+			ctx.interact_point = &ctx.bot->interact_points.back();
+			ctx.parse_type = Container_Interacting;
+		} },
+	};
+	constexpr _KeyEntry INTERACT_POINT_KEYS[] = {
+		{ "joint",		[](_ParseContext &ctx, const _ParsedLine &line) { ctx.interact_point->hashed_joint_name = HashedString(line.value.data(), line.value.size()); } },
+		{ "radius",		[](_ParseContext &ctx, const _ParsedLine &line) { ctx.interact_point->interact_radius = _view_to_double(line.value); } },
+		{ "ui_text",	[](_ParseContext &ctx, const _ParsedLine &line) { _append_tokens(ctx.interact_point->ui_text, line.rest); } },
+		{ "pickup",		[](_ParseContext &ctx, const _ParsedLine &line) { ctx.interact_point->pickup = true; } },
+	};
+
+	// Slot is picked from the top bits of hash * multiplier. The multiplier is searched at compile time
+	// until every key lands in its own slot, so adding keys never requires tuning anything by hand.
+	constexpr unsigned int KEY_DISPATCH_SLOT_BITS = 6;
+	constexpr unsigned int KEY_DISPATCH_SLOT_COUNT = 1 << KEY_DISPATCH_SLOT_BITS;
+
+	constexpr unsigned int _get_key_slot(unsigned int hash, unsigned int multiplier) {
+		return (hash * multiplier) >> (32 - KEY_DISPATCH_SLOT_BITS);
+	}
+	template <size_t N>
+	constexpr unsigned int _find_key_multiplier(const _KeyEntry (&keys)[N]) {
+		for (unsigned int multiplier = 1; multiplier < 1000000; multiplier += 2) {
+			bool used[KEY_DISPATCH_SLOT_COUNT] = {};
+			bool collision = false;
+
+			for (size_t i = 0; i < N && !collision; i++) {
+				unsigned int slot = _get_key_slot(_parse_key_hash(keys[i].key), multiplier);
+				collision = used[slot];
+				used[slot] = true;
+			}
+
+			if (!collision) { return multiplier; }
 		}
+		return 0;
+	}
+	struct _KeyDispatchTable {
+		unsigned int multiplier = 0;
+		std::array<int, KEY_DISPATCH_SLOT_COUNT> slots = {};
+	};
+	template <size_t N>
+	constexpr _KeyDispatchTable _build_key_dispatch_table(const _KeyEntry (&keys)[N]) {
+		_KeyDispatchTable table;
+		table.multiplier = _find_key_multiplier(keys);
+		for (unsigned int i = 0; i < KEY_DISPATCH_SLOT_COUNT; i++) { table.slots[i] = -1; }
+		for (size_t i = 0; i < N; i++) {
+			table.slots[_get_key_slot(_parse_key_hash(keys[i].key), table.multiplier)] = (int)i;
+		}
+		return table;
+	}
 
-		return true;
+	constexpr _KeyDispatchTable BOT_DEFINITION_KEY_TABLE = _build_key_dispatch_table(BOT_DEFINITION_KEYS);
+	constexpr _KeyDispatchTable INTERACT_POINT_KEY_TABLE = _build_key_dispatch_table(INTERACT_POINT_KEYS);
+	static_assert(BOT_DEFINITION_KEY_TABLE.multiplier, "No perfect hash found for bot definition keys, increase KEY_DISPATCH_SLOT_BITS.");
+	static_assert(INTERACT_POINT_KEY_TABLE.multiplier, "No perfect hash found for interact point keys, increase KEY_DISPATCH_SLOT_BITS.");
+
+	const _KeyEntry *_find_key_entry(const _KeyDispatchTable &table, const _KeyEntry *keys, std::string_view key) {
+		int index = table.slots[_get_key_slot(_parse_key_hash(key), table.multiplier)];
+		if (index < 0 || keys[index].key != key) { return nullptr; }
+		return &keys[index];
 	}
-	void parse_bot_definitions(const std::string &buf, const std::string &file_name) {
 
-		std::vector<std::string> lines = split(buf, "\n");
+	void parse_bot_definitions(const std::string &buf, const std::string &file_name) {
+		parse_bot_definitions(buf, file_name, bot_definitions);
+	}
+	void parse_bot_definitions(const std::string &buf, const std::string &file_name, BotDefinition *definitions, std::vector<std::string> *errors) {
 
 		enum ParseMode {
 			BotTypeSearch = 0,
 			Generic_values = 1,
 			Container = 2,
-		}; ParseMode parse_mode = BotTypeSearch;
-
-		enum ParseContainerType {
-			Container_None = 0,
-			Container_Interacting = 1,
-		}; ParseContainerType parse_type = Container_None;
+		};
 
 		int depth = 0;
 		BotType current_bot = BotType::BotType_COUNT;
-		BotDefinition *bot = nullptr;
-		InteractablePoint *interact_point = nullptr;
+		_ParseContext ctx;
 
+		std::string_view remaining = buf;
+		for (int i = 0; !remaining.empty(); i++) {
 
-		for (int i = 0; i < lines.size(); i++) {
-			std::string line = trim(lines[i]);
+			size_t line_end = remaining.find('\n');
+			std::string_view line = _trim_view(remaining.substr(0, line_end));
+			remaining.remove_prefix(line_end == std::string_view::npos ? remaining.size() : line_end + 1);
 
-			bool can_parse_values = (current_bot != BotType_COUNT && bot != nullptr);
+			bool can_parse_values = (current_bot != BotType_COUNT && ctx.bot != nullptr);
 
 			if (line.empty()) continue;
 			if (line.size() >= 2 && line[0] == '/' && line[1] == '/') continue;
 			if (line == "{") {
 				if (current_bot == BotType::BotType_COUNT) {
-					LOG("Error, missing bot name in file " + file_name + " line " + toString(i));
+					std::string message = "Error, missing bot name in file " + file_name + " line " + toString(i);
+					if (errors) { errors->push_back(message); } else { LOG(message); }
 				}
 				depth++;
-				parse_mode = static_cast<ParseMode>(depth);
 			} else if (line == "}") {
 				depth--;
-				parse_mode = static_cast<ParseMode>(depth);
-				parse_type = Container_None;
-				interact_point = nullptr;
+				ctx.parse_type = Container_None;
+				ctx.interact_point = nullptr;
 
 				if (depth == BotTypeSearch) {
 					current_bot = BotType::BotType_COUNT;
-					bot = nullptr;
+					ctx.bot = nullptr;
 				}
 			} else {
+				_ParsedLine parsed;
+				parsed.rest = line;
+				parsed.key = _next_token(parsed.rest);
+
 				if (depth == BotTypeSearch) {
-					std::vector<std::string> line_toks = split(line);
-					if (line_toks.empty()) continue;
 
-					current_bot = string_to_enum(line_toks[0]);
+					current_bot = string_to_enum(parsed.key);
 
 					if (current_bot == BotType_COUNT) {
-						LOG("Error, unknown bot name in file " + file_name + " line " + toString(i));
+						std::string message = "Error, unknown bot name in file " + file_name + " line " + toString(i);
+						if (errors) { errors->push_back(message); } else { LOG(message); }
 						continue;
 					}
 
-					bot_definitions[current_bot] = BotDefinition();
-					bot = &bots::bot_definitions[current_bot];
-					bot->parsed = true;
+					definitions[current_bot] = BotDefinition();
+					ctx.bot = &definitions[current_bot];
+					ctx.bot->parsed = true;
 
 				} else if (depth == Generic_values && can_parse_values) {
 
-					std::vector<std::string> toks = split(line);
-					if (toks.empty()) continue;
-					if (toks.size() < 2) {
-						platform::log("Error parsing bot definition in file " + file_name + " line " + toString(i) + " variable: " + toks[0]);
+					std::string_view values = parsed.rest;
+					parsed.value = _next_token(values);
+					parsed.value2 = _next_token(values);
+					if (parsed.value2.empty()) { parsed.value2 = parsed.value; }
+
+					if (parsed.value.empty()) {
+						std::string message = "Error parsing bot definition in file " + file_name + " line " + toString(i) + " variable: " + std::string(parsed.key);
+						if (errors) { errors->push_back(message); } else { platform::log(message); }
 						continue;
 					}
 
-					std::string_view key = toks[0];
-					const std::string &value = toks[1];
-					const std::string &value2 = toks.size() > 2 ? toks[2] : toks[1];
+					if (const _KeyEntry *entry = _find_key_entry(BOT_DEFINITION_KEY_TABLE, BOT_DEFINITION_KEYS, parsed.key)) {
+						entry->set(ctx, parsed);
+					}
+				} else if (depth == Container && can_parse_values) {
 
-					if (key == "name") {
+					std::string_view values = parsed.rest;
+					parsed.value = _next_token(values);
+					parsed.value2 = parsed.value;
 
-						bot->name = "";
+					if (parsed.value.empty()) {
+						std::string message = "Error parsing bot Container value in file " + file_name + " line " + toString(i);
+						if (errors) { errors->push_back(message); } else { platform::log(message); }
+						continue;
+					}
 
-						if (toks.size() <= 1) {
-							bot->name = "Bot";
-						} else {
-							for (int j = 1; j < toks.size(); j++) {
-								bot->name += toks[j] + " ";
-							}
-						}
-					} else if (key == "model") {
-						bot->model = value;
-					} else if (key == "agent_scale") {
-						bot->agent_scale = STRTOF(value);
-					} else if (key == "material") {
-						bot->material = value;
-					} else if (key == "collidable") {
-						bot->collidable = strutil::parse_bool(value, false);
-					} else if (key == "show_hp_bar") {
-						bot->show_hp_bar = strutil::parse_bool(value, false);
-					} else if (key == "show_name") {
-						bot->show_name = strutil::parse_bool(value, false);
-					} else if (key == "collision_radius") {
-						bot->agent_radius = STRTOF(value);
-					} else if (key == "rotation_speed") {
-						bot->rotation_speed = STRTOF(value);
-					} else if (key == "snap_to_navmesh") {
-						bot->snap_to_navmesh = strutil::parse_bool(value, false);
-					} else if (key == "rotate_node_with_pitch") {
-						bot->rotate_node_with_pitch = strutil::parse_bool(value, false);
-					} else if (key == "flying") {
-						bot->flying = strutil::parse_bool(value, false);
-					} else if (key == "max_hp") {
-						bot->min_hp = STRTOI(value);
-						bot->max_hp = STRTOI(value2);
-					}else if (key == "max_speed") {
-						bot->min_speed = STRTOF(value);
-						bot->max_speed = STRTOF(value2);
-					} else if (key == "acceleration_multiplier") {
-						bot->acceleration_multiplier = STRTOF(value);
-					} else if (key == "deceleration_multiplier") {
-						bot->deceleration_multiplier = STRTOF(value);
-					} else if (key == "team") {
-						bot->team = MAX(STRTOI(value), 0); // Ensure team is not negative
-					} else if (key == "knockback_multiplier") {
-						bot->effect_multipliers[StatusEffectType::Knockback] = STRTOF(value);
-					} else if (key == "timestop_multiplier") {
-						bot->effect_multipliers[StatusEffectType::TimeStop] = STRTOF(value);
-					} else if (key == "slow_multiplier") {
-						bot->effect_multipliers[StatusEffectType::Slow] = STRTOF(value);
-					} else if (key == "speed_multiplier") {
-						bot->effect_multipliers[StatusEffectType::Speed] = STRTOF(value);
-					} else if (key == "immobilize_multiplier") {
-						bot->effect_multipliers[StatusEffectType::Immobilize] = STRTOF(value);
-					} else if (key == "invulnerable") {
-						bot->invulnerable = strutil::parse_bool(value, false);
-					} else if (key == "difficulty_type") {
-						if (value == "heavy") {
-							bot->difficulty_type = DifficultyType_Heavy;
-						} else if (value == "elite") {
-							bot->difficulty_type = DifficultyType_Elite;
-						} else if (value == "boss") {
-							bot->difficulty_type = DifficultyType_Boss;
+					if (ctx.parse_type == Container_Interacting && ctx.interact_point) {
+						if (const _KeyEntry *entry = _find_key_entry(INTERACT_POINT_KEY_TABLE, INTERACT_POINT_KEYS, parsed.key)) {
+							entry->set(ctx, parsed);
 						}
-					} else if (key == "interactpoint") {
-
-						bot->interact_points.emplace_back();
-#ifdef PRIVATE_BUILD
-						bot->interact_points.back().debug_parsed_joint_name = value;
-#endif
-						interact_point = &bot->interact_points.back();
-						parse_type = Container_Interacting;
 					}
-				} else if (depth == Container && can_parse_values) {
+				}
+			}
+		}
+	}
 
-					std::vector<std::string> toks = split(line);
-					if (toks.size() < 2) {
-						platform::log("Error parsing bot Container value in file " + file_name + " line " + toString(i));
-						continue;
-					}
+#ifdef PRIVATE_BUILD
+	std::string _build_synthetic_bot_definitions(int definition_count) {
+
+		std::string buf;
+		buf.reserve(definition_count * 512);
+
+		for (int i = 0; i < definition_count; i++) {
+			// Cycle thru the real types, later definitions of the same type simply overwrite earlier ones.
+			BotType type = static_cast<BotType>(1 + (i % MAX(1, (int)BotType_COUNT - 1)));
+
+			buf += enum_to_case_string(type);
+			buf += "\n{\n";
+			buf += "\tname Synthetic Bot " + toString(i) + "\n";
+			buf += "\tmodel models/bots/synthetic.mdl\n";
+			buf += "\tmaterial synthetic\n";
+			buf += "\tagent_scale 1.25\n";
+			buf += "\tcollision_radius 45\n";
+			buf += "\trotation_speed 6.5\n";
+			buf += "\tmax_hp 100 " + toString(100 + i % 50) + "\n";
+			buf += "\tmax_speed 250 320\n";
+			buf += "\tacceleration_multiplier 3.0\n";
+			buf += "\tdeceleration_multiplier 1.5\n";
+			buf += "\tknockback_multiplier 0.5\n";
+			buf += "\tslow_multiplier 0.75\n";
+			buf += "\tshow_hp_bar true\n";
+			buf += "\tdifficulty_type elite\n";
+			buf += "\tinteractpoint head\n";
+			buf += "\t{\n";
+			buf += "\t\tjoint head\n";
+			buf += "\t\tradius 60\n";
+			buf += "\t\tui_text Pick up\n";
+			buf += "\t\tpickup true\n";
+			buf += "\t}\n";
+			buf += "}\n";
+		}
 
-					std::string_view key = toks[0];
-					std::string &value = toks[1];
+		return buf;
+	}
+	void benchmark_parse_bot_definitions(int definition_count, int iterations) {
 
-					if (parse_type == Container_Interacting && interact_point) {
+		const std::string buf = _build_synthetic_bot_definitions(definition_count);
+		std::vector<BotDefinition> definitions(BotType_COUNT);
 
-						if (key == "joint") {
-							interact_point->hashed_joint_name = HashedString(value.c_str(), value.size());
-						} else if (key == "radius") {
-							interact_point->interact_radius = STRTOF(value);
-						} else if (key == "ui_text") {
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++) {
+			parse_bot_definitions(buf, "synthetic", definitions.data());
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-							for (int j = 1; j < toks.size(); j++) {
-								interact_point->ui_text += toks[j] + " ";
-							}
-						} else if (key == "pickup") {
-							interact_point->pickup = true;
-						}
-					}
-				}
+		double megabytes = (double)buf.size() * iterations / (1024.0 * 1024.0);
+		PRINT("[Bots] Parsed " + toString(definition_count) + " definitions (" + toString(buf.size() / 1024) + " KB) x" + toString(iterations) +
+			" in " + toString(seconds * 1000.0) + " ms, " + toString(megabytes / MAX(seconds, 0.000001)) + " MB/s");
+	}
+	void fuzz_parse_bot_definitions(int iterations) {
+
+		const std::string source = _build_synthetic_bot_definitions(64);
+		const char noise[] = { '{', '}', '\n', ' ', '\t', '/', '0', '-', '.', 'x' };
+		std::vector<BotDefinition> definitions(BotType_COUNT);
+
+		// Mutates random bytes of a valid file, the parser should never crash or read out of bounds.
+		for (int i = 0; i < iterations; i++) {
+			std::string buf = source;
+			int mutations = 1 + randomizer.rand(32);
+			for (int m = 0; m < mutations; m++) {
+				size_t index = randomizer.rand((int)buf.size() - 1);
+				buf[index] = noise[randomizer.rand((int)sizeof(noise) - 1)];
 			}
+			if (randomizer.rand(4) == 0) {
+				buf.resize(randomizer.rand((int)buf.size() - 1));
+			}
+
+			parse_bot_definitions(buf, "fuzz", definitions.data());
 		}
+
+		PRINT("[Bots] Fuzzed bot definition parser with " + toString(iterations) + " mutated files");
 	}
+#endif
 	double get_bot_definition_range_based_hp(BotType bot_type) {
 		BotDefinition *bot_def = bots::get_bot_definition(bot_type);
 		if (!bot_def) return 1.0;
 
-		return bot_def->min_hp + MAX(0, randomizer.rand(bot_def->max_hp - bot_def->min_hp));
+		return bot_def->min_hp + MAX(0, bot_rand(bot_def->max_hp - bot_def->min_hp));
 	}
 	double get_bot_definition_range_based_speed(BotType bot_type) {
 		BotDefinition *bot_def = bots::get_bot_definition(bot_type);
 		if (!bot_def) return 1.0;
 
-		return bot_def->min_speed + MAX(0, randomizer.rand(bot_def->max_speed - bot_def->min_speed));
+		return bot_def->min_speed + MAX(0, bot_rand(bot_def->max_speed - bot_def->min_speed));
 	}
 
 	const char *enum_to_string(BotType value) {
-		switch (value) {
-			BOT_TYPE_LIST(BOT_ENUM_TO_STRING)
-		}
-
-		return nullptr;
+		if (value >= BotType_COUNT) { return nullptr; }
+		return get_bot_type_info(value).lower_name.data;
 	}
 	const char *enum_to_case_string(BotType value) {
-		switch (value) {
-			BOT_TYPE_LIST(BOT_ENUM_TO_CASE_STRING)
-		}
-
-		return nullptr;
+		if (value >= BotType_COUNT) { return nullptr; }
+		return get_bot_type_info(value).case_name.data();
 	}
-	BotType string_to_enum(std::string key) {
-
-		if (!startsWith(toLower(key), "bottype_")) {
-			key = "bottype_" + key;
-		}
-
-		BOT_TYPE_LIST(BOT_STRING_TO_ENUM)
-			return BotType::BotType_COUNT;
+	BotType string_to_enum(std::string_view key) {
+		return find_bot_type(key);
 	}
 	std::string enum_to_string_without_identifier(const std::string &key) {
 		return key.substr(8);
 	}
 
-	void initialize_bot_state_by_type(Agent &agent) {
-		BotState &bot_state = agent.bot_state;
-		bot_state.type = agent.bot_state.type;
+	void _reset_bot_state_for_spawn(BotState &bot_state) {
 
 		for (int i = 0; i < StatusEffectType::StatusEffectCount; i++) {
 			StatusEffect &effect = bot_state.movement.movement_effects[i];
@@ -284,16 +473,64 @@ namespace bots {
 
 		bot_state.movement.effect_multipliers[StatusEffectType::Knockback] = 0.0;
 
-		apply_bot_definition(agent);
+		// navmesh::Path is owned by the navmesh module, so it keeps its capacity instead of being pooled.
+		bot_state.movement.path.clear();
+		bot_state.movement.path.reserve(BOT_RESERVED_PATH_WAYPOINTS);
+		bot_state.movement.path_cursor.remaining_lengths.clear();
+		bot_state.movement.path_cursor.remaining_lengths.reserve(BOT_RESERVED_PATH_WAYPOINTS);
+		bot_state.movement.path_cursor.corners.clear();
+		bot_state.targets.clear();
+		reset_attack_cooldowns(bot_state.attack_cooldowns);
+
+		// Per life state, warm states would otherwise carry it over from whichever bot used them last.
+		bot_state.target_agent_id = NO_TARGET;
+		bot_state.last_los_check_time = 0;
+		bot_state.crowd_controlled = false;
+		bot_state.engaged_combat = false;
+		bot_state.global_action_cooldown = 0;
+		bot_state.time_outside_player_sight = 0;
+		bot_state.last_damaged_time = 0;
+		bot_state.behavior_lod = BehaviorLod();
+
+		// dormant / dormant_cell are cleared by wake_bot() in _cleanup_previous_bot_life, it needs them to find the index cell.
+		bot_state.dormant_since = 0;
+		bot_state.idle_time = 0;
+	}
+	void _cleanup_previous_bot_life(Agent &agent) {
 
 		ai_manager_on_bot_death(netserver::state, agent);
+		forget_bot_replication(agent.player_id);
+
+		// A bot that died while parked must not stay in the DormantBotIndex.
+		wake_bot(agent);
 
 		HookParameters params_cleanup;
 		params_cleanup.target = &agent;
 		params_cleanup.source = &agent;
 		battle_callbacks::fire_event_on_agent(params_cleanup, EVENT_ON_BOT_CLEANUP, &agent);
-		battle_callbacks::clear_and_apply_bot_callbacks(agent);
+	}
+
+	void initialize_bot_state_by_type(Agent &agent) {
+		BotState &bot_state = agent.bot_state;
+		bot_state.type = agent.bot_state.type;
 
+		if (warm_bot_pool_enabled) {
+
+			// The previous life has to be cleaned up while the agent still holds its BotState.
+			_cleanup_previous_bot_life(agent);
+
+			// Only differs from the default path when the agent changes BotType, it then takes over the containers
+			// of a previous bot of the new type. The definition and callbacks are applied in full either way.
+			take_warm_bot_state(agent);
+			_reset_bot_state_for_spawn(bot_state);
+			apply_bot_definition(agent);
+			battle_callbacks::clear_and_apply_bot_callbacks(agent);
+		} else {
+			_reset_bot_state_for_spawn(bot_state);
+			apply_bot_definition(agent);
+			_cleanup_previous_bot_life(agent);
+			battle_callbacks::clear_and_apply_bot_callbacks(agent);
+		}
 
 		ascension::add_ascension_buffs(agent);
 
@@ -315,23 +552,74 @@ namespace bots {
 
 	void update_bots_pre(const std::vector<Agent*>& active_bots, double dt) {
 
+		record_bot_replay_tick_pre(active_bots, dt);
+
+		// Clear scalar StatusEffects that have run out (only scheduled in closed form mode).
+		update_status_effect_expiries(timing::elapsed_time_seconds);
+
+		// Sets the ready bits of attacks coming off cooldown before any state checks them.
+		if (timer_wheel_cooldowns) {
+			update_bot_timer_wheel();
+		}
+
+		// Swap in reloaded bot definitions before anything reads them this tick.
+		update_bot_definitions_hot_reload();
+
+		// Idle bots are parked and left out of the rest of the pipeline until woken up.
+		const std::vector<Agent *> &awake_bots = update_bot_dormancy(active_bots, dt);
+
 		// In order for Avoidance to know our movement intention, we need to update our velocity beforehand. 
 		// Otherwise Avoidance will miss-judge by a tiny bit which creates a big miss over multiple frames.
-		update_intended_velocity(active_bots, dt);
+		update_intended_velocity(awake_bots, dt);
 
 		// We pre-calculate avoidance for all bots by using a "snapshot" the current state.
 		// This ensures consistent behavior by removing dependencies on the update order,
 		// preventing bots from reacting to partially updated states of other bots.
-		update_avoidance_velocity(active_bots, dt);
+		update_avoidance_velocity(awake_bots, dt);
 	}
 	void update_bots(const std::vector<Agent *> &active_bots, double dt, const unsigned int turn) {
 
+		record_bot_replay_tick_update(turn);
+
+		const std::vector<Agent *> &players = gamestate::get_ai_manager(netserver::state).alive_active_players;
+
+		// Steering is batched, so every bot has to move before any of them can run its behavior.
+		if (fast_steering) {
+			for (Agent *bot : active_bots) {
+				if (bot->bot_state.dormant) { continue; }
+				update_movement(*bot, dt);
+			}
+			update_steering_batch(dt);
+		}
+
 		for (Agent *bot : active_bots) {
-			update_movement(*bot, dt);
-			update_behavior(*bot, dt);
+			if (bot->bot_state.dormant) { continue; }
+
+			if (!fast_steering) {
+				update_movement(*bot, dt);
+			}
+
+			if (!behavior_lod_enabled) {
+				update_behavior(*bot, dt);
+				continue;
+			}
+
+			// Far away bots run their behavior at a reduced rate with the dt accumulated in between.
+			double behavior_dt = dt;
+			update_behavior_lod(*bot, players);
+			if (should_update_behavior(*bot, turn, dt, behavior_dt)) {
+				update_behavior(*bot, behavior_dt);
+			}
 		}
 	}
 	void update_bots_post(const std::vector<Agent *> &active_bots, double dt) {
 		// <---Not shown in showcase--> //
+
+		// Everything bots replicated this tick goes out as one message per client.
+		if (batched_bot_replication) {
+			flush_bot_replication();
+		}
+
+		record_bot_replay_tick_post();
 	}
 }
\ No newline at end of file
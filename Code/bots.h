@@ -1,12 +1,31 @@
 #pragma once
 #define AI_SUPPORT
 
+#include "bots_scalar.h"
+#include "bots_containers.h"
 #include "bots_movement.h"
 #include "bots_status_effects.h"
 #include "bots_state_handling.h"
 #include "bots_targeting.h"
+#include "bots_timer_wheel.h"
 #include "bots_utility.h"
 #include "bots_constants.h"
+#include "bots_type_info.h"
+#include "bots_definition_blob.h"
+#include "bots_hot_reload.h"
+#include "bots_profiling.h"
+#include "bots_dormancy.h"
+#include "bots_replication.h"
+#include "bots_root_motion.h"
+#include "bots_steering.h"
+#include "bots_replay.h"
+#include "bots_perf_suite.h"
+#include "bots_warm_pool.h"
+#include "bots_path_smoothing.h"
+#include "bots_flyer_paths.h"
+#include "bots_avoidance_entities.h"
+#include "bots_orca.h"
+#include "bots_crowd_field.h"
 #include <deque>
 
 struct Agent;
@@ -67,6 +86,7 @@ namespace bots {
         double acceleration_multiplier = 3.0;
         double deceleration_multiplier = 1.0;
         double rotation_speed = 0;
+        AvoidanceMode avoidance_mode = AvoidanceMode_Pairwise;
 
         std::vector<InteractablePoint> interact_points;
 
@@ -81,9 +101,10 @@ namespace bots {
 
         Movement movement;
         StateMachine state_machine;
+        BehaviorLod behavior_lod;
 
         TargetingContext target_context;    // Setup for each bot's targeting criterias. Per default set to None which fallbacks to Proximity.
-        std::vector<BotTarget> targets;     // Container of potential targets and history related to them.
+        BotTargetList targets;              // Container of potential targets and history related to them.
         int     target_agent_id = NO_TARGET; 
         double  last_los_check_time = 0;    // Timestamp for last line of sight check.
 
@@ -91,6 +112,12 @@ namespace bots {
         bool    interactable = false;       // Indicates wether the bot is interactable or not.
         bool    crowd_controlled = false;   // Used by StatusEffects to indicate if we can run the behavior update or not.
         bool    engaged_combat = false;     // Used by aggro system and is toggled to true once a target is detected within aggro range.
+        bool    dormant = false;            // Parked in the DormantBotIndex and skipped by the update loop.
+        long long dormant_cell = 0;         // The DormantBotIndex cell we are parked in.
+        double  dormant_since = 0;
+        double  idle_time = 0;              // How long is_bot_idle() has been true, bots go dormant after DORMANT_IDLE_TIME.
+        BotType warm_type = BotType_COUNT;  // The type this state was last spawned as, used by the WarmBotStatePool.
+        BotAttackCooldowns attack_cooldowns;// Ready bits of attacks scheduled on the BotTimerWheel.
         double  spawn_timestamp = -1;
         double  global_action_cooldown = 0;
         double  time_outside_player_sight = 0; 
@@ -105,12 +132,23 @@ namespace bots {
 
     const char *enum_to_string(BotType value);
     const char *enum_to_case_string(BotType value);
-    BotType string_to_enum(std::string key);
+    BotType string_to_enum(std::string_view key);
     std::string enum_to_string_without_identifier(const std::string &key);
 
     BotDefinition *get_bot_definition(BotType bot_type);
     void parse_bot_definitions(const std::string &buf, const std::string &file_name);
+    // With errors set, parse errors are collected there instead of logged, e.g. when parsing off the main thread.
+    void parse_bot_definitions(const std::string &buf, const std::string &file_name, BotDefinition *definitions /*BotType_COUNT sized*/, std::vector<std::string> *errors = nullptr);
     bool apply_bot_definition(Agent &agent);
+    // The parts of apply_bot_definition, split so pooled BotStates can be prewarmed without an agent.
+    void apply_bot_definition_to_agent(Agent &agent, const BotDefinition &bot_def);
+    void apply_bot_definition_to_bot_state(BotState &bot_state, const BotDefinition &bot_def);
+    void roll_bot_definition_ranges(Agent &agent, const BotDefinition &bot_def);
+#ifdef PRIVATE_BUILD
+    // Dev helpers for the definition parser, reports MB/s for a synthetic file / feeds it randomly mutated files.
+    void benchmark_parse_bot_definitions(int definition_count = 10000, int iterations = 10);
+    void fuzz_parse_bot_definitions(int iterations = 1000);
+#endif
     double get_bot_definition_range_based_hp(BotType bot_type);
     double get_bot_definition_range_based_speed(BotType bot_type);
 
@@ -0,0 +1,101 @@
+#include "bots.h"
+
+namespace bots {
+
+	const double AVOIDANCE_ENTITY_CELL_SIZE = 500.0;
+
+	bool indexed_avoidance_entities = false;
+
+	AvoidanceEntityIndex &get_avoidance_entity_index() {
+		static AvoidanceEntityIndex index;
+		return index;
+	}
+
+	long long _get_avoidance_cell_key(int cell_x, int cell_z) {
+		return (long long)(((unsigned long long)(unsigned int)cell_x << 32) | (unsigned int)cell_z);
+	}
+	void _get_avoidance_cell_range(const V3 &position, double radius, OUT int &min_x, OUT int &min_z, OUT int &max_x, OUT int &max_z) {
+		min_x = (int)floor((position.x - radius) / AVOIDANCE_ENTITY_CELL_SIZE);
+		min_z = (int)floor((position.z - radius) / AVOIDANCE_ENTITY_CELL_SIZE);
+		max_x = (int)floor((position.x + radius) / AVOIDANCE_ENTITY_CELL_SIZE);
+		max_z = (int)floor((position.z + radius) / AVOIDANCE_ENTITY_CELL_SIZE);
+	}
+	bool _avoidance_entities_changed(const AvoidanceEntityIndex &index) {
+
+		if (index.fetched.size() != index.entities.size()) { return true; }
+
+		for (size_t i = 0; i < index.fetched.size(); i++) {
+			const V3 &fetched_position = index.fetched[i].position;
+			const V3 &position = index.entities[i].position;
+			if (fetched_position.x != position.x || fetched_position.y != position.y || fetched_position.z != position.z) { return true; }
+			if (index.fetched[i].radius != index.entities[i].radius) { return true; }
+		}
+		return false;
+	}
+	void _rebuild_avoidance_entity_index(AvoidanceEntityIndex &index) {
+
+		// Cells keep their capacity, an emptied cell is reused once an entity moves back into it.
+		for (auto &cell : index.cells) {
+			cell.second.clear();
+		}
+
+		for (unsigned int i = 0; i < index.entities.size(); i++) {
+			const component::AvoidanceEntityData &entity = index.entities[i];
+
+			int min_x, min_z, max_x, max_z;
+			_get_avoidance_cell_range(entity.position, entity.radius, min_x, min_z, max_x, max_z);
+
+			for (int x = min_x; x <= max_x; x++) {
+				for (int z = min_z; z <= max_z; z++) {
+					index.cells[_get_avoidance_cell_key(x, z)].push_back(i);
+				}
+			}
+		}
+
+		index.query_stamps.assign(index.entities.size(), index.query_stamp);
+		index.rebuilds++;
+	}
+
+	void update_avoidance_entity_index() {
+
+		AvoidanceEntityIndex &index = get_avoidance_entity_index();
+
+		index.fetched.clear();
+		component::get_avoidance_entities(*game::level, index.fetched);
+
+		if (!_avoidance_entities_changed(index)) { return; }
+
+		std::swap(index.entities, index.fetched);
+		_rebuild_avoidance_entity_index(index);
+	}
+	const std::vector<unsigned int> &query_avoidance_entities(const V3 &position, double radius) {
+
+		AvoidanceEntityIndex &index = get_avoidance_entity_index();
+		index.query_results.clear();
+		if (index.entities.empty()) { return index.query_results; }
+
+		// Stamps dedupe entities that span several of the queried cells.
+		if (++index.query_stamp == 0) {
+			std::fill(index.query_stamps.begin(), index.query_stamps.end(), 0);
+			index.query_stamp = 1;
+		}
+
+		int min_x, min_z, max_x, max_z;
+		_get_avoidance_cell_range(position, radius, min_x, min_z, max_x, max_z);
+
+		for (int x = min_x; x <= max_x; x++) {
+			for (int z = min_z; z <= max_z; z++) {
+				auto it = index.cells.find(_get_avoidance_cell_key(x, z));
+				if (it == index.cells.end()) { continue; }
+
+				for (unsigned int entity_index : it->second) {
+					if (index.query_stamps[entity_index] == index.query_stamp) { continue; }
+
+					index.query_stamps[entity_index] = index.query_stamp;
+					index.query_results.push_back(entity_index);
+				}
+			}
+		}
+		return index.query_results;
+	}
+}
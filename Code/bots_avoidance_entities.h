@@ -0,0 +1,29 @@
+#pragma once
+#include <unordered_map>
+
+namespace bots {
+
+    // Level avoidance entities bucketed in an xz grid. Each entity is inserted into every cell its radius overlaps,
+    // so a bot only has to look at the cells its own radius overlaps. The grid is rebuilt only when the set of
+    // entities, or any of their positions or radii, differs from the previous tick, and all buffers keep their capacity.
+    struct AvoidanceEntityIndex {
+        std::vector<component::AvoidanceEntityData> entities;
+        std::vector<component::AvoidanceEntityData> fetched;           // This tick's entities, compared against entities.
+        std::unordered_map<long long, std::vector<unsigned int>> cells; // Cell key -> entity indices.
+        std::vector<unsigned int> query_stamps;                         // Per entity, last query that returned it.
+        std::vector<unsigned int> query_results;
+        unsigned int query_stamp = 0;
+        unsigned long long rebuilds = 0;
+    };
+
+    // Enables the spatial index for level avoidance entities in update_avoidance_velocity.
+    extern bool indexed_avoidance_entities;
+
+    AvoidanceEntityIndex &get_avoidance_entity_index();
+
+    // Fetches the level's avoidance entities and rebuilds the grid if any of them was added, removed or moved.
+    void update_avoidance_entity_index();
+
+    // Indices into AvoidanceEntityIndex::entities of the entities that might overlap the circle, valid until the next query.
+    const std::vector<unsigned int> &query_avoidance_entities(const V3 &position, double radius);
+}
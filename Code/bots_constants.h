@@ -33,6 +33,40 @@ namespace bots {
 
 	extern const double PER_PLAYER_HEALTH_MULTIPLIER;
 
+	extern const double TRANSITION_DISTANCE_BAND_SIZE;
+	extern const size_t RECENT_STATEMACHINE_STATES_MAX;
+
+	extern const unsigned int BEHAVIOR_LOD_INTERVALS[];
+	extern const double BEHAVIOR_LOD_DISTANCES[];
+	extern const double BEHAVIOR_LOD_OUT_OF_SIGHT_TIME;
+	extern const double BEHAVIOR_LOD_FULL_RATE_DURATION;
+
+	extern const double DORMANT_IDLE_TIME;
+	extern const double DORMANT_CELL_SIZE;
+	extern const double DORMANT_MAX_AGGRO_RANGE;
+
+	extern const double PATH_SMOOTHING_COLLINEAR_COS;
+	extern const int PATH_SMOOTHING_MAX_TRACES;
+	extern const double PATH_CORNER_SLOWDOWN_WEIGHT;
+	extern const double PATH_CORNER_SLOWDOWN_RADIUS;
+
+	extern const double FLYER_CLUSTER_SIZE;
+	extern const double FLYER_ROUTE_LIFETIME;
+	extern const size_t FLYER_ROUTE_CACHE_MAX;
+
+	extern const double AVOIDANCE_ENTITY_CELL_SIZE;
+
+	extern const double ORCA_TIME_HORIZON;
+	extern const double ORCA_NEIGHBOUR_DISTANCE;
+
+	extern const double CROWD_FIELD_CELL_SIZE;
+	extern const size_t CROWD_FIELD_MAX_NODES;
+	extern const double CROWD_FIELD_PRESSURE;
+	extern const double CROWD_FIELD_COMFORT_DENSITY;
+	extern const double CROWD_FIELD_FLOW_ALIGNMENT;
+
+	extern const double BOT_TIMER_WHEEL_RESOLUTION;
+
 /*
 	====================================================================================
 
@@ -40,17 +74,13 @@ namespace bots {
 		  and automatically generate conversions for below.
 		  This automatically reflects new options to the editor etc and is convenient for parsing etc:
 			- The enum definition (BotType)
-			- String-to-enum conversion
-			- Enum-to-string conversion
+			- The constexpr BotTypeInfo / lookup tables in bots_type_info.h (string <-> enum)
 			- Enum-to-string pairs (for UI options)
 
 	====================================================================================
 */
 
 #define BOT_ENUM(key, value) key = value,
-#define BOT_STRING_TO_ENUM(enum_name, value) if (toLower(key) == toLower(#enum_name)) return BotType::enum_name;
-#define BOT_ENUM_TO_STRING(key, value) case key: return toLower(#key).c_str();
-#define BOT_ENUM_TO_CASE_STRING(key, value) case key: return #key;
 #define BOT_ENUM_TO_STRING_PAIR(key, value) {toString(value), enum_to_string_without_identifier(#key)},
 
 #define BOT_TYPE_LIST(FUNC)\
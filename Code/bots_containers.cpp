@@ -0,0 +1,71 @@
+#include "bots.h"
+
+namespace bots {
+
+	BotContainerPool &get_bot_container_pool() {
+		static BotContainerPool pool;
+		return pool;
+	}
+
+	size_t _get_size_class(size_t bytes, OUT size_t &class_bytes) {
+		size_t size_class = 0;
+		class_bytes = BOT_CONTAINER_POOL_MIN_BLOCK;
+		while (class_bytes < bytes) {
+			class_bytes <<= 1;
+			size_class++;
+		}
+		return size_class;
+	}
+
+	void *bot_pool_allocate(size_t bytes, OUT size_t &out_bytes) {
+
+		BotContainerPool &pool = get_bot_container_pool();
+
+		size_t class_bytes = 0;
+		size_t size_class = _get_size_class(bytes, class_bytes);
+
+		if (size_class >= BOT_CONTAINER_POOL_SIZE_CLASSES) {
+			pool.stats.oversized_allocations++;
+			out_bytes = bytes;
+			return ::operator new(bytes);
+		}
+
+		out_bytes = class_bytes;
+		pool.stats.block_allocations++;
+
+		if (BotContainerPool::FreeBlock *block = pool.free_lists[size_class]) {
+			pool.free_lists[size_class] = block->next;
+			pool.stats.block_reuses++;
+			return block;
+		}
+
+		// Blocks are never returned to the chunks, a freed block only serves its own size class from then on.
+		if (pool.chunk_offset + class_bytes > BOT_CONTAINER_POOL_CHUNK_SIZE) {
+			pool.chunks.push_back(static_cast<unsigned char *>(::operator new(BOT_CONTAINER_POOL_CHUNK_SIZE)));
+			pool.chunk_offset = 0;
+			pool.stats.chunk_allocations++;
+		}
+
+		void *block = pool.chunks.back() + pool.chunk_offset;
+		pool.chunk_offset += class_bytes;
+		return block;
+	}
+	void bot_pool_free(void *block, size_t bytes) {
+
+		if (!block) { return; }
+
+		BotContainerPool &pool = get_bot_container_pool();
+
+		size_t class_bytes = 0;
+		size_t size_class = _get_size_class(bytes, class_bytes);
+
+		if (size_class >= BOT_CONTAINER_POOL_SIZE_CLASSES) {
+			::operator delete(block);
+			return;
+		}
+
+		BotContainerPool::FreeBlock *free_block = static_cast<BotContainerPool::FreeBlock *>(block);
+		free_block->next = pool.free_lists[size_class];
+		pool.free_lists[size_class] = free_block;
+	}
+}
@@ -0,0 +1,239 @@
+#pragma once
+#include <algorithm>
+#include <new>
+#include <utility>
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Pooled containers for per bot state.
+          InlineVector keeps the first N elements inside the owning struct and only spills
+          into blocks taken from the BotContainerPool once it grows past that. The pool hands out
+          power of two sized blocks carved from large chunks, and freed blocks go back onto a
+          free list per size class. Once a session has warmed up, bots spawning, re-pathing and
+          dying no longer touch the global heap.
+
+          Only used from the bot update thread.
+
+    ====================================================================================
+*/
+
+    const size_t BOT_CONTAINER_POOL_CHUNK_SIZE = 64 * 1024;
+    const size_t BOT_CONTAINER_POOL_MIN_BLOCK = 64;
+    const size_t BOT_CONTAINER_POOL_SIZE_CLASSES = 11;     // 64 bytes to 64 KB, larger blocks go to the global heap.
+
+    struct BotContainerPoolStats {
+        unsigned long long chunk_allocations = 0;   // Global allocations made to grow the pool.
+        unsigned long long oversized_allocations = 0;
+        unsigned long long block_allocations = 0;
+        unsigned long long block_reuses = 0;        // Served from a free list.
+    };
+
+    struct BotContainerPool {
+        struct FreeBlock { FreeBlock *next; };
+
+        FreeBlock *free_lists[BOT_CONTAINER_POOL_SIZE_CLASSES] = {};
+        std::vector<unsigned char *> chunks;
+        size_t chunk_offset = BOT_CONTAINER_POOL_CHUNK_SIZE;
+        BotContainerPoolStats stats;
+    };
+
+    BotContainerPool &get_bot_container_pool();
+
+    // bytes is rounded up to the size class, which is returned in out_bytes. The same out_bytes must be passed to free.
+    void *bot_pool_allocate(size_t bytes, OUT size_t &out_bytes);
+    void bot_pool_free(void *block, size_t bytes);
+
+    template <typename T, size_t N>
+    struct InlineVector {
+
+        InlineVector() {}
+        InlineVector(const InlineVector &other) { _copy_from(other); }
+        InlineVector(InlineVector &&other) noexcept { _move_from(other); }
+        ~InlineVector() { clear(); _release(); }
+
+        InlineVector &operator=(const InlineVector &other) {
+            if (this != &other) { clear(); _copy_from(other); }
+            return *this;
+        }
+        InlineVector &operator=(InlineVector &&other) noexcept {
+            if (this != &other) { clear(); _release(); _move_from(other); }
+            return *this;
+        }
+
+        T *begin() { return items; }
+        T *end() { return items + count; }
+        const T *begin() const { return items; }
+        const T *end() const { return items + count; }
+
+        T &operator[](size_t index) { return items[index]; }
+        const T &operator[](size_t index) const { return items[index]; }
+        T &back() { return items[count - 1]; }
+        const T &back() const { return items[count - 1]; }
+        T *data() { return items; }
+        const T *data() const { return items; }
+
+        size_t size() const { return count; }
+        size_t capacity() const { return capacity_; }
+        bool empty() const { return count == 0; }
+        bool is_inline() const { return items == _inline_items(); }
+
+        void push_back(const T &value) { emplace_back(value); }
+        template <typename... Args>
+        T &emplace_back(Args &&...args) {
+            if (count == capacity_) { reserve(capacity_ * 2); }
+            T *item = new (items + count) T(std::forward<Args>(args)...);
+            count++;
+            return *item;
+        }
+        void pop_back() {
+            items[--count].~T();
+        }
+        T *erase(T *position) {
+            for (T *it = position; it + 1 < end(); ++it) {
+                *it = std::move(*(it + 1));
+            }
+            pop_back();
+            return position;
+        }
+        void clear() {
+            for (size_t i = 0; i < count; i++) {
+                items[i].~T();
+            }
+            count = 0;
+        }
+        void reserve(size_t new_capacity) {
+            if (new_capacity <= capacity_) { return; }
+
+            size_t block_bytes = 0;
+            T *new_items = static_cast<T *>(bot_pool_allocate(new_capacity * sizeof(T), block_bytes));
+            for (size_t i = 0; i < count; i++) {
+                new (new_items + i) T(std::move(items[i]));
+                items[i].~T();
+            }
+
+            _release();
+            items = new_items;
+            capacity_ = block_bytes / sizeof(T);
+        }
+
+    private:
+        T *_inline_items() const { return reinterpret_cast<T *>(const_cast<unsigned char *>(inline_storage)); }
+
+        // Gives a spilled block back to the pool and points items at the inline storage again.
+        void _release() {
+            if (!is_inline()) {
+                bot_pool_free(items, capacity_ * sizeof(T));
+            }
+            items = _inline_items();
+            capacity_ = N;
+        }
+        void _copy_from(const InlineVector &other) {
+            reserve(other.count);
+            for (size_t i = 0; i < other.count; i++) {
+                new (items + i) T(other.items[i]);
+            }
+            count = other.count;
+        }
+        void _move_from(InlineVector &other) {
+            if (other.is_inline()) {
+                for (size_t i = 0; i < other.count; i++) {
+                    new (items + i) T(std::move(other.items[i]));
+                }
+                count = other.count;
+                other.clear();
+                return;
+            }
+
+            // Steal the spilled block.
+            items = other.items;
+            count = other.count;
+            capacity_ = other.capacity_;
+            other.items = other._inline_items();
+            other.count = 0;
+            other.capacity_ = N;
+        }
+
+        alignas(T) unsigned char inline_storage[N * sizeof(T)];
+        T *items = _inline_items();
+        size_t count = 0;
+        size_t capacity_ = N;
+    };
+
+    // Set of agent ids as a dense bitset. Every word carries the epoch it was written in, and words from an older
+    // epoch read as empty, so clear() only bumps the epoch. Ids below 64 * N go into the bitset, the rare larger
+    // ones into a short overflow list that is searched linearly and emptied lazily on the first use in a new epoch.
+    template <size_t N>
+    struct HitSet {
+
+        bool contains(int id) const {
+            if (id < 0) { return false; }
+
+            const size_t word = (size_t)id / 64;
+            if (word >= N) {
+                return overflow_epoch == epoch && std::find(overflow.begin(), overflow.end(), id) != overflow.end();
+            }
+            return words[word].epoch == epoch && (words[word].bits & (1ull << (id % 64)));
+        }
+        // Returns false if the id was already in the set.
+        bool insert(int id) {
+            if (id < 0) { return false; }
+
+            const size_t word_index = (size_t)id / 64;
+            if (word_index >= N) {
+                return _insert_overflow(id);
+            }
+
+            Word &word = words[word_index];
+            if (word.epoch != epoch) {
+                word.bits = 0;
+                word.epoch = epoch;
+            }
+
+            const unsigned long long bit = 1ull << (id % 64);
+            if (word.bits & bit) { return false; }
+
+            word.bits |= bit;
+            count++;
+            return true;
+        }
+        void clear() {
+            count = 0;
+            if (++epoch) { return; }
+
+            // Wrapped, words stamped with the old epochs could read as current again.
+            for (Word &word : words) { word.epoch = 0; }
+            overflow_epoch = 0;
+            epoch = 1;
+        }
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+    private:
+        struct Word {
+            unsigned long long bits = 0;
+            unsigned int epoch = 0;
+        };
+
+        bool _insert_overflow(int id) {
+            if (overflow_epoch != epoch) {
+                overflow.clear();
+                overflow_epoch = epoch;
+            }
+            if (std::find(overflow.begin(), overflow.end(), id) != overflow.end()) { return false; }
+
+            overflow.push_back(id);
+            count++;
+            return true;
+        }
+
+        Word words[N];
+        InlineVector<int, 4> overflow;      // Ids of 64 * N and up.
+        unsigned int epoch = 1;
+        unsigned int overflow_epoch = 0;
+        size_t count = 0;
+    };
+}
@@ -0,0 +1,183 @@
+#include "bots.h"
+
+namespace bots {
+
+	const double CROWD_FIELD_CELL_SIZE = 100.0;
+	const size_t CROWD_FIELD_MAX_NODES = 256 * 256;		// The cells grow instead when the horde spreads out further than this covers.
+	const double CROWD_FIELD_PRESSURE = 1.5;			// Push away from denser cells, in effective max speeds per unit of density difference.
+	const double CROWD_FIELD_COMFORT_DENSITY = 0.3;		// Below this bots move freely, above it they start following the flow.
+	const double CROWD_FIELD_FLOW_ALIGNMENT = 0.5;
+
+	CrowdFieldState &get_crowd_field_state() {
+		static CrowdFieldState state;
+		return state;
+	}
+
+	bool _uses_crowd_field(const Movement &movement) {
+		return movement.avoidance_enabled && movement.avoidance_mode == AvoidanceMode_DensityField;
+	}
+	CrowdField *_find_crowd_field(CrowdFieldState &state, int team) {
+		for (size_t i = 0; i < state.field_count; i++) {
+			if (state.fields[i].team == team) { return &state.fields[i]; }
+		}
+		return nullptr;
+	}
+	double _get_node_weight(const CrowdField &field, int node_x, int node_z, double x, double z) {
+
+		// Bilinear tent around the node, one cell wide in each direction.
+		const double dx = fabs(x - (field.origin_x + node_x * field.cell_size)) / field.cell_size;
+		const double dz = fabs(z - (field.origin_z + node_z * field.cell_size)) / field.cell_size;
+		return MAX(0.0, 1.0 - dx) * MAX(0.0, 1.0 - dz);
+	}
+	void _setup_crowd_field(CrowdField &field) {
+
+		// Padded by two cells so gradient samples half a cell outside the bots stay within the grid.
+		double cell_size = CROWD_FIELD_CELL_SIZE;
+		const double extent_x = field.max_x - field.min_x;
+		const double extent_z = field.max_z - field.min_z;
+		while (((extent_x / cell_size) + 5.0) * ((extent_z / cell_size) + 5.0) > CROWD_FIELD_MAX_NODES) {
+			cell_size *= 2.0;
+		}
+
+		field.cell_size = cell_size;
+		field.origin_x = floor(field.min_x / cell_size) * cell_size - 2.0 * cell_size;
+		field.origin_z = floor(field.min_z / cell_size) * cell_size - 2.0 * cell_size;
+		field.width = (int)((field.max_x - field.origin_x) / cell_size) + 3;
+		field.height = (int)((field.max_z - field.origin_z) / cell_size) + 3;
+
+		const size_t node_count = (size_t)field.width * field.height;
+		field.density.assign(node_count, 0.0);
+		field.momentum_x.assign(node_count, 0.0);
+		field.momentum_z.assign(node_count, 0.0);
+	}
+	void _splat_crowd_field(CrowdField &field, const V3 &position, const V3 &velocity, double weight) {
+
+		const int node_x = (int)floor((position.x - field.origin_x) / field.cell_size);
+		const int node_z = (int)floor((position.z - field.origin_z) / field.cell_size);
+
+		for (int x = node_x; x <= node_x + 1; x++) {
+			for (int z = node_z; z <= node_z + 1; z++) {
+				if (x < 0 || z < 0 || x >= field.width || z >= field.height) { continue; }
+
+				const size_t node = (size_t)z * field.width + x;
+				const double node_weight = weight * _get_node_weight(field, x, z, position.x, position.z);
+				field.density[node] += node_weight;
+				field.momentum_x[node] += velocity.x * node_weight;
+				field.momentum_z[node] += velocity.z * node_weight;
+			}
+		}
+	}
+	// Bilinear sample at (x, z) with the bot's own splat at self_position taken back out.
+	void _sample_crowd_field(const CrowdField &field, double x, double z, const V3 &self_position, const V3 &self_velocity, double self_weight,
+		OUT double &density, OUT double &momentum_x, OUT double &momentum_z) {
+
+		density = momentum_x = momentum_z = 0.0;
+
+		const int node_x = (int)floor((x - field.origin_x) / field.cell_size);
+		const int node_z = (int)floor((z - field.origin_z) / field.cell_size);
+
+		for (int nx = node_x; nx <= node_x + 1; nx++) {
+			for (int nz = node_z; nz <= node_z + 1; nz++) {
+				if (nx < 0 || nz < 0 || nx >= field.width || nz >= field.height) { continue; }
+
+				const size_t node = (size_t)nz * field.width + nx;
+				const double self_node_weight = self_weight * _get_node_weight(field, nx, nz, self_position.x, self_position.z);
+				const double sample_weight = _get_node_weight(field, nx, nz, x, z);
+
+				density += (field.density[node] - self_node_weight) * sample_weight;
+				momentum_x += (field.momentum_x[node] - self_velocity.x * self_node_weight) * sample_weight;
+				momentum_z += (field.momentum_z[node] - self_velocity.z * self_node_weight) * sample_weight;
+			}
+		}
+
+		density = MAX(density, 0.0);
+	}
+	double _get_crowd_field_weight(const Agent &agent, double cell_size) {
+		const double radius = get_avoidance_radius_by_type(agent);
+		return (TRIG_PI * radius * radius) / (cell_size * cell_size);
+	}
+
+	void update_crowd_field_avoidance(const std::vector<Agent *> &agents) {
+
+		CrowdFieldState &state = get_crowd_field_state();
+		state.field_count = 0;
+
+		// Find the teams that need a field.
+		for (Agent *agent : agents) {
+			if (!agent || !_uses_crowd_field(agent->bot_state.movement)) { continue; }
+			if (_find_crowd_field(state, agent->team)) { continue; }
+
+			if (state.field_count == state.fields.size()) { state.fields.emplace_back(); }
+
+			CrowdField &field = state.fields[state.field_count++];
+			field.team = agent->team;
+			field.min_x = field.max_x = agent->battle_state.position.x;
+			field.min_z = field.max_z = agent->battle_state.position.z;
+		}
+
+		if (!state.field_count) { return; }
+
+		// Bounds cover every bot of the team, density field bots also make way for the others.
+		for (Agent *agent : agents) {
+			if (!agent || !agent->bot_state.movement.avoidance_enabled) { continue; }
+
+			CrowdField *field = _find_crowd_field(state, agent->team);
+			if (!field) { continue; }
+
+			const V3 &position = agent->battle_state.position;
+			field->min_x = MIN(field->min_x, position.x);
+			field->min_z = MIN(field->min_z, position.z);
+			field->max_x = MAX(field->max_x, position.x);
+			field->max_z = MAX(field->max_z, position.z);
+		}
+
+		for (size_t i = 0; i < state.field_count; i++) {
+			_setup_crowd_field(state.fields[i]);
+		}
+
+		for (Agent *agent : agents) {
+			if (!agent || !agent->bot_state.movement.avoidance_enabled) { continue; }
+
+			CrowdField *field = _find_crowd_field(state, agent->team);
+			if (!field) { continue; }
+
+			_splat_crowd_field(*field, agent->battle_state.position, agent->bot_state.movement.velocity, _get_crowd_field_weight(*agent, field->cell_size));
+		}
+
+		for (Agent *agent : agents) {
+			if (!agent) { continue; }
+
+			Movement &movement = agent->bot_state.movement;
+			if (!_uses_crowd_field(movement)) { continue; }
+
+			const CrowdField &field = *_find_crowd_field(state, agent->team);
+			const V3 &position = agent->battle_state.position;
+			const double weight = _get_crowd_field_weight(*agent, field.cell_size);
+			const double h = field.cell_size * 0.5;
+
+			double density, flow_x, flow_z;
+			double density_px, density_nx, density_pz, density_nz, unused_x, unused_z;
+			_sample_crowd_field(field, position.x, position.z, position, movement.velocity, weight, density, flow_x, flow_z);
+			_sample_crowd_field(field, position.x + h, position.z, position, movement.velocity, weight, density_px, unused_x, unused_z);
+			_sample_crowd_field(field, position.x - h, position.z, position, movement.velocity, weight, density_nx, unused_x, unused_z);
+			_sample_crowd_field(field, position.x, position.z + h, position, movement.velocity, weight, density_pz, unused_x, unused_z);
+			_sample_crowd_field(field, position.x, position.z - h, position, movement.velocity, weight, density_nz, unused_x, unused_z);
+
+			// Density difference across one cell, pushing towards the emptier side.
+			const double effective_max_speed = get_effective_max_speed(movement);
+			V3 avoidance = V3(density_nx - density_px, 0.0, density_nz - density_pz) * (CROWD_FIELD_PRESSURE * effective_max_speed);
+			if (avoidance.length_squared() > effective_max_speed * effective_max_speed) {
+				avoidance = avoidance.normalized() * effective_max_speed;
+			}
+
+			// In a packed crowd, move with the others instead of into them.
+			if (density > CROWD_FIELD_COMFORT_DENSITY) {
+				const double saturation = CLAMP((density - CROWD_FIELD_COMFORT_DENSITY) / (1.0 - CROWD_FIELD_COMFORT_DENSITY), 0.0, 1.0);
+				const V3 flow_velocity = V3(flow_x, 0.0, flow_z) / density;
+				avoidance += (flow_velocity - V3(movement.velocity.x, 0.0, movement.velocity.z)) * (saturation * CROWD_FIELD_FLOW_ALIGNMENT);
+			}
+
+			movement.avoidance = avoidance;
+		}
+	}
+}
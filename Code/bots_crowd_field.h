@@ -0,0 +1,43 @@
+#pragma once
+
+struct Agent;
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Continuum crowd field for bots with AvoidanceMode_DensityField, meant for large hordes.
+          Every tick the bots of each team are splatted onto a 2D grid. Each bot's covered area
+          goes into density, and its velocity weighted by that area goes into momentum. Density field
+          bots then steer down the density gradient and, where the crowd is dense, blend into the
+          local flow instead of testing their neighbours pair by pair.
+
+          Cost is one splat and five samples (centre plus the four gradient taps) per bot, plus clearing
+          the grid, so linear in bot count and field size. The field is a snapshot of the current velocities,
+          so no dt is involved.
+
+    ====================================================================================
+*/
+
+    struct CrowdField {
+        int team = 0;
+        double origin_x = 0.0, origin_z = 0.0;  // Position of node (0, 0).
+        double cell_size = 0.0;
+        int width = 0, height = 0;              // In nodes.
+        std::vector<BotScalar> density;            // Covered fraction of the cell around each node.
+        std::vector<BotScalar> momentum_x, momentum_z;
+
+        double min_x = 0.0, min_z = 0.0, max_x = 0.0, max_z = 0.0; // Bounds of this tick's bots, scratch.
+    };
+
+    struct CrowdFieldState {
+        std::vector<CrowdField> fields;         // One per team with density field bots, keep their capacity between ticks.
+        size_t field_count = 0;
+    };
+
+    CrowdFieldState &get_crowd_field_state();
+
+    // Writes Movement::avoidance of every bot in AvoidanceMode_DensityField, called from update_avoidance_velocity().
+    void update_crowd_field_avoidance(const std::vector<Agent *> &agents);
+}
@@ -0,0 +1,319 @@
+#include "bots.h"
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace bots {
+
+	struct _BlobWriter {
+		std::vector<BotDefinitionRecord> records;
+		std::vector<BotInteractPointRecord> interact_points;
+		std::vector<char> string_table;
+
+		BotDefinitionBlobString add_string(const std::string &str) {
+			BotDefinitionBlobString result;
+			result.offset = (unsigned int)string_table.size();
+			result.size = (unsigned int)str.size();
+			string_table.insert(string_table.end(), str.begin(), str.end());
+			return result;
+		}
+	};
+
+	// Maps a file read-only for the duration of the load. Falls back to reading the file into a buffer on other platforms.
+	struct _MappedFile {
+		const unsigned char *data = nullptr;
+		size_t size = 0;
+
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#else
+		std::vector<unsigned char> buffer;
+#endif
+	};
+
+	bool _map_file(const std::string &path, OUT _MappedFile &mapped) {
+#ifdef _WIN32
+		mapped.file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (mapped.file == INVALID_HANDLE_VALUE) { return false; }
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(mapped.file, &file_size) || file_size.QuadPart == 0) { return false; }
+
+		mapped.mapping = CreateFileMappingA(mapped.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapped.mapping) { return false; }
+
+		mapped.data = static_cast<const unsigned char *>(MapViewOfFile(mapped.mapping, FILE_MAP_READ, 0, 0, 0));
+		mapped.size = (size_t)file_size.QuadPart;
+		return mapped.data != nullptr;
+#else
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) { return false; }
+
+		mapped.buffer.resize((size_t)file.tellg());
+		file.seekg(0);
+		file.read(reinterpret_cast<char *>(mapped.buffer.data()), mapped.buffer.size());
+
+		mapped.data = mapped.buffer.data();
+		mapped.size = mapped.buffer.size();
+		return !mapped.buffer.empty();
+#endif
+	}
+	void _unmap_file(_MappedFile &mapped) {
+#ifdef _WIN32
+		if (mapped.data) { UnmapViewOfFile(mapped.data); }
+		if (mapped.mapping) { CloseHandle(mapped.mapping); }
+		if (mapped.file != INVALID_HANDLE_VALUE) { CloseHandle(mapped.file); }
+		mapped.file = INVALID_HANDLE_VALUE;
+		mapped.mapping = nullptr;
+#endif
+		mapped.data = nullptr;
+		mapped.size = 0;
+	}
+
+	unsigned int get_bot_definition_checksum(const void *data, size_t size) {
+
+		// FNV-1a, good enough to catch truncated or corrupted files.
+		const unsigned char *bytes = static_cast<const unsigned char *>(data);
+		unsigned int hash = 2166136261u;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	bool compile_bot_definitions(const std::string &buf, const std::string &file_name, OUT std::vector<unsigned char> &out_blob) {
+
+		// Parse into a scratch array so that compiling never touches the live definitions.
+		std::vector<BotDefinition> definitions(BotType_COUNT);
+		parse_bot_definitions(buf, file_name, definitions.data());
+
+		_BlobWriter writer;
+
+		for (unsigned int type = 0; type < BotType_COUNT; type++) {
+			const BotDefinition &def = definitions[type];
+			if (!def.parsed) { continue; }
+
+			BotDefinitionRecord &record = writer.records.emplace_back();
+			record.bot_type = type;
+			record.difficulty_type = def.difficulty_type;
+			record.team = def.team;
+			record.min_hp = def.min_hp;
+			record.max_hp = def.max_hp;
+			record.min_speed = def.min_speed;
+			record.max_speed = def.max_speed;
+			record.agent_scale = def.agent_scale;
+			record.agent_radius = def.agent_radius;
+			record.agent_height = def.agent_height;
+			record.acceleration_multiplier = def.acceleration_multiplier;
+			record.deceleration_multiplier = def.deceleration_multiplier;
+			record.rotation_speed = def.rotation_speed;
+			record.avoidance_mode = def.avoidance_mode;
+			record.name = writer.add_string(def.name);
+			record.model = writer.add_string(def.model);
+			record.material = writer.add_string(def.material);
+
+			for (int i = 0; i < StatusEffectCount; i++) {
+				record.effect_multipliers[i] = def.effect_multipliers[i];
+			}
+
+			record.flags |= def.flying ? BlobFlag_Flying : 0;
+			record.flags |= def.collidable ? BlobFlag_Collidable : 0;
+			record.flags |= def.show_hp_bar ? BlobFlag_ShowHpBar : 0;
+			record.flags |= def.show_name ? BlobFlag_ShowName : 0;
+			record.flags |= def.interactable ? BlobFlag_Interactable : 0;
+			record.flags |= def.snap_to_navmesh ? BlobFlag_SnapToNavmesh : 0;
+			record.flags |= def.invulnerable ? BlobFlag_Invulnerable : 0;
+			record.flags |= def.hitboxes_active ? BlobFlag_HitboxesActive : 0;
+			record.flags |= def.rotate_node_with_pitch ? BlobFlag_RotateNodeWithPitch : 0;
+			record.flags |= def.rotate_with_steering ? BlobFlag_RotateWithSteering : 0;
+
+			record.first_interact_point = (unsigned int)writer.interact_points.size();
+			record.interact_point_count = (unsigned int)def.interact_points.size();
+
+			for (const InteractablePoint &point : def.interact_points) {
+				BotInteractPointRecord &point_record = writer.interact_points.emplace_back();
+				point_record.hashed_joint_name = point.hashed_joint_name;
+				point_record.interact_radius = point.interact_radius;
+				point_record.pickup = point.pickup;
+				point_record.ui_text = writer.add_string(point.ui_text);
+#ifdef PRIVATE_BUILD
+				point_record.joint_name = writer.add_string(point.debug_parsed_joint_name);
+#endif
+			}
+		}
+
+		const size_t records_size = writer.records.size() * sizeof(BotDefinitionRecord);
+		const size_t points_size = writer.interact_points.size() * sizeof(BotInteractPointRecord);
+		const size_t payload_size = records_size + points_size + writer.string_table.size();
+
+		BotDefinitionBlobHeader header;
+		header.bot_type_count = BotType_COUNT;
+		header.status_effect_count = StatusEffectCount;
+		header.definition_count = (unsigned int)writer.records.size();
+		header.interact_point_count = (unsigned int)writer.interact_points.size();
+		header.string_table_size = (unsigned int)writer.string_table.size();
+		header.payload_size = (unsigned int)payload_size;
+		header.source_checksum = get_bot_definition_checksum(buf.data(), buf.size());
+
+		out_blob.resize(sizeof(header) + payload_size);
+		unsigned char *payload = out_blob.data() + sizeof(header);
+		if (records_size) { memcpy(payload, writer.records.data(), records_size); }
+		if (points_size) { memcpy(payload + records_size, writer.interact_points.data(), points_size); }
+		if (writer.string_table.size()) { memcpy(payload + records_size + points_size, writer.string_table.data(), writer.string_table.size()); }
+
+		header.payload_checksum = get_bot_definition_checksum(payload, payload_size);
+		memcpy(out_blob.data(), &header, sizeof(header));
+
+		return true;
+	}
+	bool compile_bot_definitions_file(const std::string &source_path, const std::string &blob_path) {
+
+		std::ifstream source(source_path, std::ios::binary);
+		if (!source) {
+			LOG("Error, could not open bot definitions " + source_path);
+			return false;
+		}
+
+		std::string buf((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+
+		std::vector<unsigned char> blob;
+		if (!compile_bot_definitions(buf, source_path, blob)) { return false; }
+
+		std::ofstream out(blob_path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			LOG("Error, could not write compiled bot definitions " + blob_path);
+			return false;
+		}
+
+		out.write(reinterpret_cast<const char *>(blob.data()), blob.size());
+		return out.good();
+	}
+
+	bool load_compiled_bot_definitions(const unsigned char *data, size_t size, BotDefinition *definitions, const unsigned int *source_checksum) {
+
+		if (!data || size < sizeof(BotDefinitionBlobHeader)) { return false; }
+
+		BotDefinitionBlobHeader header;
+		memcpy(&header, data, sizeof(header));
+
+		if (header.magic != BOT_DEFINITION_BLOB_MAGIC || header.version != BOT_DEFINITION_BLOB_VERSION) {
+			LOG("Compiled bot definitions have an unknown version, recompile the script.");
+			return false;
+		}
+		if (header.bot_type_count != BotType_COUNT || header.status_effect_count != StatusEffectCount) {
+			LOG("Compiled bot definitions are stale (BotType or StatusEffect count changed), recompile the script.");
+			return false;
+		}
+		if (source_checksum && header.source_checksum != *source_checksum) {
+			LOG("Compiled bot definitions are stale (script changed since it was compiled), recompile the script.");
+			return false;
+		}
+
+		const size_t records_size = (size_t)header.definition_count * sizeof(BotDefinitionRecord);
+		const size_t points_size = (size_t)header.interact_point_count * sizeof(BotInteractPointRecord);
+		if (header.payload_size != records_size + points_size + header.string_table_size ||
+			size < sizeof(header) + header.payload_size) {
+			LOG("Compiled bot definitions are truncated.");
+			return false;
+		}
+
+		const unsigned char *payload = data + sizeof(header);
+		if (get_bot_definition_checksum(payload, header.payload_size) != header.payload_checksum) {
+			LOG("Compiled bot definitions failed the checksum.");
+			return false;
+		}
+
+		// Records are copied out rather than cast in place since a mapped view gives no alignment guarantees.
+		const unsigned char *points = payload + records_size;
+		const char *strings = reinterpret_cast<const char *>(points + points_size);
+
+		auto read_string = [&](const BotDefinitionBlobString &str, std::string &out) {
+			if ((size_t)str.offset + str.size > header.string_table_size) { return; }
+			out.assign(strings + str.offset, str.size);
+		};
+
+		for (unsigned int i = 0; i < header.definition_count; i++) {
+			BotDefinitionRecord record;
+			memcpy(&record, payload + i * sizeof(BotDefinitionRecord), sizeof(record));
+
+			if (record.bot_type >= BotType_COUNT) { continue; }
+			if ((size_t)record.first_interact_point + record.interact_point_count > header.interact_point_count) { continue; }
+
+			BotDefinition &def = definitions[record.bot_type];
+			def = BotDefinition();
+			def.parsed = true;
+			def.difficulty_type = static_cast<DifficultyType>(record.difficulty_type);
+			def.team = record.team;
+			def.min_hp = record.min_hp;
+			def.max_hp = record.max_hp;
+			def.min_speed = record.min_speed;
+			def.max_speed = record.max_speed;
+			def.agent_scale = record.agent_scale;
+			def.agent_radius = record.agent_radius;
+			def.agent_height = record.agent_height;
+			def.acceleration_multiplier = record.acceleration_multiplier;
+			def.deceleration_multiplier = record.deceleration_multiplier;
+			def.rotation_speed = record.rotation_speed;
+			def.avoidance_mode = record.avoidance_mode < AvoidanceMode_COUNT ? static_cast<AvoidanceMode>(record.avoidance_mode) : AvoidanceMode_Pairwise;
+			read_string(record.name, def.name);
+			read_string(record.model, def.model);
+			read_string(record.material, def.material);
+
+			for (int e = 0; e < StatusEffectCount; e++) {
+				def.effect_multipliers[e] = record.effect_multipliers[e];
+			}
+
+			def.flying = record.flags & BlobFlag_Flying;
+			def.collidable = record.flags & BlobFlag_Collidable;
+			def.show_hp_bar = record.flags & BlobFlag_ShowHpBar;
+			def.show_name = record.flags & BlobFlag_ShowName;
+			def.interactable = record.flags & BlobFlag_Interactable;
+			def.snap_to_navmesh = record.flags & BlobFlag_SnapToNavmesh;
+			def.invulnerable = record.flags & BlobFlag_Invulnerable;
+			def.hitboxes_active = record.flags & BlobFlag_HitboxesActive;
+			def.rotate_node_with_pitch = record.flags & BlobFlag_RotateNodeWithPitch;
+			def.rotate_with_steering = record.flags & BlobFlag_RotateWithSteering;
+
+			def.interact_points.resize(record.interact_point_count);
+			for (unsigned int p = 0; p < record.interact_point_count; p++) {
+				BotInteractPointRecord point_record;
+				memcpy(&point_record, points + (record.first_interact_point + p) * sizeof(BotInteractPointRecord), sizeof(point_record));
+
+				InteractablePoint &point = def.interact_points[p];
+				point.hashed_joint_name = (size_t)point_record.hashed_joint_name;
+				point.interact_radius = point_record.interact_radius;
+				point.pickup = point_record.pickup;
+				read_string(point_record.ui_text, point.ui_text);
+#ifdef PRIVATE_BUILD
+				read_string(point_record.joint_name, point.debug_parsed_joint_name);
+#endif
+			}
+		}
+
+		return true;
+	}
+	bool load_compiled_bot_definitions_file(const std::string &blob_path, const std::string &source_path) {
+
+		// Hashing the script is a single pass over the bytes, still far cheaper than parsing it.
+		unsigned int source_checksum = 0;
+		bool has_source = false;
+		if (!source_path.empty()) {
+			std::ifstream source(source_path, std::ios::binary);
+			if (source) {
+				std::string buf((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+				source_checksum = get_bot_definition_checksum(buf.data(), buf.size());
+				has_source = true;
+			}
+		}
+
+		_MappedFile mapped;
+		bool loaded = _map_file(blob_path, mapped) && load_compiled_bot_definitions(mapped.data, mapped.size, bot_definitions, has_source ? &source_checksum : nullptr);
+		_unmap_file(mapped);
+
+		return loaded;
+	}
+}
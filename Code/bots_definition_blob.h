@@ -0,0 +1,106 @@
+#pragma once
+#include <vector>
+
+namespace bots {
+
+    struct BotDefinition;
+
+/*
+    ====================================================================================
+
+          Precompiled bot definitions.
+          The text script stays the authoring format and is compiled offline into a blob:
+
+            [BotDefinitionBlobHeader]
+            [BotDefinitionRecord     x definition_count]
+            [BotInteractPointRecord  x interact_point_count]
+            [string table            x string_table_size bytes]
+
+          Everything after the header is covered by the checksum. Records only contain
+          PODs and offsets into the string table, so loading is a single pass without
+          any per-line allocations or string matching.
+
+    ====================================================================================
+*/
+
+    const unsigned int BOT_DEFINITION_BLOB_MAGIC = 0x46454442; // "BDEF"
+    const unsigned int BOT_DEFINITION_BLOB_VERSION = 2;        // Bump when any of the records below change layout.
+
+    struct BotDefinitionBlobString {
+        unsigned int offset = 0;
+        unsigned int size = 0;
+    };
+    struct BotDefinitionBlobHeader {
+        unsigned int magic = BOT_DEFINITION_BLOB_MAGIC;
+        unsigned int version = BOT_DEFINITION_BLOB_VERSION;
+        unsigned int bot_type_count = 0;        // BotType_COUNT at compile time, a mismatch means the blob is older than the enum.
+        unsigned int status_effect_count = 0;   // StatusEffectCount at compile time.
+        unsigned int definition_count = 0;
+        unsigned int interact_point_count = 0;
+        unsigned int string_table_size = 0;
+        unsigned int payload_size = 0;
+        unsigned int payload_checksum = 0;      // FNV-1a of everything after the header.
+        unsigned int source_checksum = 0;       // FNV-1a of the text script it was compiled from.
+    };
+
+    enum BotDefinitionBlobFlags : unsigned int {
+        BlobFlag_Flying = 1 << 0,
+        BlobFlag_Collidable = 1 << 1,
+        BlobFlag_ShowHpBar = 1 << 2,
+        BlobFlag_ShowName = 1 << 3,
+        BlobFlag_Interactable = 1 << 4,
+        BlobFlag_SnapToNavmesh = 1 << 5,
+        BlobFlag_Invulnerable = 1 << 6,
+        BlobFlag_HitboxesActive = 1 << 7,
+        BlobFlag_RotateNodeWithPitch = 1 << 8,
+        BlobFlag_RotateWithSteering = 1 << 9,
+    };
+
+    struct BotDefinitionRecord {
+        unsigned int bot_type = 0;
+        unsigned int flags = 0;
+        int difficulty_type = 0;
+        int team = 0;
+        int min_hp = 0;
+        int max_hp = 0;
+        int min_speed = 0;
+        int max_speed = 0;
+        unsigned int first_interact_point = 0;
+        unsigned int interact_point_count = 0;
+        unsigned int avoidance_mode = 0;
+
+        double agent_scale = 1.0;
+        double agent_radius = 0;
+        double agent_height = 0;
+        double acceleration_multiplier = 3.0;
+        double deceleration_multiplier = 1.0;
+        double rotation_speed = 0;
+        double effect_multipliers[StatusEffectCount] = {};
+
+        BotDefinitionBlobString name;
+        BotDefinitionBlobString model;
+        BotDefinitionBlobString material;
+    };
+    struct BotInteractPointRecord {
+        unsigned long long hashed_joint_name = 0;
+        double interact_radius = 50.0;
+        unsigned int pickup = 0;
+        BotDefinitionBlobString ui_text;
+        BotDefinitionBlobString joint_name; // Only used for PRIVATE_BUILD debugging.
+    };
+
+    unsigned int get_bot_definition_checksum(const void *data, size_t size);
+
+    // Offline step: runs the text parser and serializes all parsed definitions into out_blob.
+    bool compile_bot_definitions(const std::string &buf, const std::string &file_name, OUT std::vector<unsigned char> &out_blob);
+    bool compile_bot_definitions_file(const std::string &source_path, const std::string &blob_path);
+
+    // Validates and unpacks a blob into definitions (BotType_COUNT sized). Nothing is written if validation fails.
+    // With a source_checksum, a blob compiled from any other version of the script is rejected as stale.
+    bool load_compiled_bot_definitions(const unsigned char *data, size_t size, BotDefinition *definitions, const unsigned int *source_checksum = nullptr);
+
+    // Memory maps the blob file and loads it into bot_definitions. Returns false if the blob is missing, stale or corrupt,
+    // in which case the caller should fall back to parse_bot_definitions(). The blob is stale if it was compiled from
+    // another version of the script at source_path, builds that don't ship the script skip that check.
+    bool load_compiled_bot_definitions_file(const std::string &blob_path, const std::string &source_path = "");
+}
@@ -0,0 +1,181 @@
+#include "bots.h"
+
+namespace bots {
+
+	const double DORMANT_IDLE_TIME = 2.0;			// How long a bot has to stay idle before it goes dormant.
+	const double DORMANT_CELL_SIZE = 1000.0;
+	const double DORMANT_MAX_AGGRO_RANGE = 5000.0;	// Bots with a larger aggro range engage too easily to be worth parking.
+	const double DORMANT_WAKE_MARGIN = 1.1;			// Wake slightly before a player enters the aggro range.
+
+	bool dormant_bots_enabled = false;
+
+	DormantBotIndex &get_dormant_bot_index() {
+		static DormantBotIndex index;
+		return index;
+	}
+
+	long long _get_dormant_cell_key(int cell_x, int cell_z) {
+		return ((long long)cell_x << 32) ^ (long long)(unsigned int)cell_z;
+	}
+	long long _get_dormant_cell_key(const V3 &position) {
+		return _get_dormant_cell_key((int)floor(position.x / DORMANT_CELL_SIZE), (int)floor(position.z / DORMANT_CELL_SIZE));
+	}
+	void _remove_from_dormant_cell(DormantBotIndex &index, const Agent &agent) {
+
+		auto it = index.cells.find(agent.bot_state.dormant_cell);
+		if (it == index.cells.end()) { return; }
+
+		std::vector<unsigned int> &ids = it->second;
+		for (size_t i = 0; i < ids.size(); i++) {
+			if (ids[i] != agent.player_id) { continue; }
+
+			std::swap(ids[i], ids.back());
+			ids.pop_back();
+			index.dormant_count--;
+			break;
+		}
+	}
+	void _make_dormant(DormantBotIndex &index, Agent &agent) {
+
+		BotState &bot_state = agent.bot_state;
+		bot_state.dormant = true;
+		bot_state.dormant_since = timing::elapsed_time_seconds;
+		bot_state.dormant_cell = _get_dormant_cell_key(agent.battle_state.position);
+
+		// Cells keep their capacity once created, so parking bots stops allocating after warm up.
+		index.cells[bot_state.dormant_cell].push_back(agent.player_id);
+		index.max_aggro_range = MAX(index.max_aggro_range, bot_state.aggro_range.x);
+		index.dormant_count++;
+	}
+	bool _should_wake(const Agent &agent) {
+
+		const BotState &bot_state = agent.bot_state;
+		if (!agent.battle_state.alive) { return false; }
+		if (bot_state.last_damaged_time > bot_state.dormant_since) { return true; }
+
+		return !is_bot_idle(agent);
+	}
+	void _wake_bots_near_players(DormantBotIndex &index, const std::vector<Agent *> &players) {
+
+		if (!index.dormant_count) { return; }
+
+		const double query_range = index.max_aggro_range * DORMANT_WAKE_MARGIN;
+		const int cell_range = (int)ceil(query_range / DORMANT_CELL_SIZE);
+
+		for (Agent *player : players) {
+			if (!player) { continue; }
+
+			const V3 &player_pos = player->battle_state.position;
+			const int player_cell_x = (int)floor(player_pos.x / DORMANT_CELL_SIZE);
+			const int player_cell_z = (int)floor(player_pos.z / DORMANT_CELL_SIZE);
+
+			for (int x = player_cell_x - cell_range; x <= player_cell_x + cell_range; x++) {
+				for (int z = player_cell_z - cell_range; z <= player_cell_z + cell_range; z++) {
+
+					auto it = index.cells.find(_get_dormant_cell_key(x, z));
+					if (it == index.cells.end()) { continue; }
+
+					std::vector<unsigned int> &ids = it->second;
+					for (size_t i = 0; i < ids.size();) {
+						Agent *bot = gamestate::get_agent_by_id(netserver::state, ids[i]);
+
+						// Remove ids of bots that no longer exist or whose id got reused.
+						if (!bot || !bot->bot_state.dormant) {
+							std::swap(ids[i], ids.back());
+							ids.pop_back();
+							index.dormant_count--;
+							continue;
+						}
+
+						const double wake_range = bot->bot_state.aggro_range.x * DORMANT_WAKE_MARGIN;
+						if ((player_pos - bot->battle_state.position).length_xz_squared() <= wake_range * wake_range) {
+							// wake_bot swaps the last id into slot i, so don't advance.
+							wake_bot(*bot);
+							continue;
+						}
+						i++;
+					}
+				}
+			}
+		}
+	}
+
+	bool is_bot_idle(const Agent &agent) {
+
+		const BotState &bot_state = agent.bot_state;
+		const Movement &movement = bot_state.movement;
+
+		if (bot_state.engaged_combat || bot_state.crowd_controlled) { return false; }
+		if (!movement.path.empty() || movement.velocity.length_squared() > 0.01) { return false; }
+
+		for (const StatusEffect &effect : movement.movement_effects) {
+			if (effect.active) { return false; }
+		}
+
+		return true;
+	}
+	void wake_bot(Agent &agent) {
+
+		BotState &bot_state = agent.bot_state;
+		bot_state.idle_time = 0.0;
+
+		if (!bot_state.dormant) { return; }
+
+		_remove_from_dormant_cell(get_dormant_bot_index(), agent);
+		bot_state.dormant = false;
+	}
+	const std::vector<Agent *> &update_bot_dormancy(const std::vector<Agent *> &active_bots, double dt) {
+
+		DormantBotIndex &index = get_dormant_bot_index();
+		index.awake_bots.clear();
+
+		if (!dormant_bots_enabled) {
+
+			// Switched off while bots were parked, hand them back to the pipeline.
+			if (index.dormant_count) {
+				for (Agent *bot : active_bots) {
+					if (bot && bot->bot_state.dormant) { wake_bot(*bot); }
+				}
+				index.cells.clear();
+				index.dormant_count = 0;
+				index.max_aggro_range = 0.0;
+			}
+
+			index.awake_bots.insert(index.awake_bots.end(), active_bots.begin(), active_bots.end());
+			return index.awake_bots;
+		}
+
+		_wake_bots_near_players(index, gamestate::get_ai_manager(netserver::state).alive_active_players);
+
+		if (!index.dormant_count) {
+			index.max_aggro_range = 0.0;
+		}
+
+		for (Agent *bot : active_bots) {
+			if (!bot) { continue; }
+
+			BotState &bot_state = bot->bot_state;
+
+			// Dormant bots only cost a few flag checks, catching damage, chained aggro and status effects.
+			if (bot_state.dormant) {
+				if (!_should_wake(*bot)) { continue; }
+				wake_bot(*bot);
+			}
+
+			if (is_bot_idle(*bot) && bot_state.aggro_range.x <= DORMANT_MAX_AGGRO_RANGE) {
+				bot_state.idle_time += dt;
+			} else {
+				bot_state.idle_time = 0.0;
+			}
+
+			if (bot_state.idle_time >= DORMANT_IDLE_TIME) {
+				_make_dormant(index, *bot);
+				continue;
+			}
+
+			index.awake_bots.push_back(bot);
+		}
+
+		return index.awake_bots;
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <unordered_map>
+
+struct Agent;
+
+namespace bots {
+
+    // Idle bots (no engagement, no movement, no path, no effects) are parked in a grid keyed index
+    // and skipped by the whole bot pipeline until something wakes them up.
+    struct DormantBotIndex {
+        std::unordered_map<long long, std::vector<unsigned int>> cells;    // Cell key -> agent ids.
+        std::vector<Agent *> awake_bots;                                    // Scratch list handed to the pipeline each tick.
+        double max_aggro_range = 0.0;                                       // Largest aggro range of any dormant bot, bounds the wake query.
+        size_t dormant_count = 0;
+    };
+
+    // Enables moving idle bots out of the update loop.
+    extern bool dormant_bots_enabled;
+
+    DormantBotIndex &get_dormant_bot_index();
+
+    // Wakes dormant bots that got damaged, engaged or affected, or that have a player within aggro range,
+    // parks bots that have been idle long enough, and returns the bots that should be updated this tick.
+    const std::vector<Agent *> &update_bot_dormancy(const std::vector<Agent *> &active_bots, double dt);
+
+    bool is_bot_idle(const Agent &agent);
+    void wake_bot(Agent &agent);
+}
@@ -0,0 +1,149 @@
+#include "bots.h"
+
+namespace bots {
+
+	const double FLYER_CLUSTER_SIZE = 1500.0;
+	const double FLYER_ROUTE_LIFETIME = 3.0;
+	const size_t FLYER_ROUTE_CACHE_MAX = 256;		// Expired routes are swept once the cache grows past this.
+
+	bool hierarchical_flyer_paths = false;
+
+	FlyerRouteCache &get_flyer_route_cache() {
+		static FlyerRouteCache cache;
+		return cache;
+	}
+
+	void _get_flyer_cluster(const V3 &position, OUT int &x, OUT int &y, OUT int &z) {
+		x = (int)floor(position.x / FLYER_CLUSTER_SIZE);
+		y = (int)floor(position.y / FLYER_CLUSTER_SIZE);
+		z = (int)floor(position.z / FLYER_CLUSTER_SIZE);
+	}
+	unsigned long long _get_flyer_cluster_key(const V3 &position) {
+		int x, y, z;
+		_get_flyer_cluster(position, x, y, z);
+
+		// 10 bits per axis covers +-512 clusters, which is well beyond any level.
+		return ((unsigned long long)(x & 0x3FF) << 20) | ((unsigned long long)(y & 0x3FF) << 10) | (unsigned long long)(z & 0x3FF);
+	}
+	unsigned long long _get_flyer_route_key(unsigned long long start_cluster, unsigned long long goal_cluster) {
+		return (start_cluster << 30) | goal_cluster;
+	}
+	bool _search_navgrid(const V3 &from, const V3 &to, OUT navmesh::Path &path) {
+		return path_find_navgrid(gamestate::get_navgrid(netserver::state), from, to, path, true);
+	}
+	void _sweep_expired_flyer_routes(FlyerRouteCache &cache) {
+
+		for (auto it = cache.routes.begin(); it != cache.routes.end();) {
+			if (it->second.expire_time <= timing::elapsed_time_seconds) {
+				it = cache.routes.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+	void _store_flyer_route(FlyerRouteCache &cache, unsigned long long key, unsigned long long start_cluster, unsigned long long goal_cluster, const navmesh::Path &path) {
+
+		if (path.size() < 2) { return; }
+
+		FlyerRoute route;
+		route.path = path;
+		route.expire_time = timing::elapsed_time_seconds + FLYER_ROUTE_LIFETIME;
+
+		// Walk from the start (back) towards the destination (front) and find where the route crosses the clusters.
+		bool found_exit = false;
+		for (size_t n = path.size(); n-- > 0;) {
+			const unsigned long long cluster = _get_flyer_cluster_key(path[n]);
+
+			if (!found_exit && cluster != start_cluster) {
+				route.start_exit = n;
+				found_exit = true;
+			}
+			if (cluster == goal_cluster) {
+				route.goal_entry = n;
+				break;
+			}
+		}
+
+		// A route that never leaves the start cluster or never reaches the goal cluster is of no use to others.
+		if (!found_exit || _get_flyer_cluster_key(path[route.goal_entry]) != goal_cluster) { return; }
+
+		if (cache.routes.size() >= FLYER_ROUTE_CACHE_MAX) {
+			_sweep_expired_flyer_routes(cache);
+		}
+		cache.routes[key] = std::move(route);
+	}
+	void _append_waypoint(navmesh::Path &path, const V3 &waypoint) {
+
+		// The joined segments share their end points, keep only one of them.
+		const double threshold_sq = MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD * MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD;
+		if (!path.empty() && (path.back() - waypoint).length_squared() <= threshold_sq) { return; }
+
+		path.push_back(waypoint);
+	}
+	bool _build_path_from_route(FlyerRouteCache &cache, const FlyerRoute &route, const V3 &start_position, const V3 &target_pos, OUT navmesh::Path &out_path) {
+
+		// The route must not be written into out_path before both local searches succeeded, out_path could be the only copy of the bot's path.
+		static navmesh::Path joined;
+		joined.clear();
+
+		// Goal side, from where the route enters the goal cluster to the exact target.
+		const double threshold_sq = MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD * MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD;
+		size_t route_begin = 0;
+		if ((route.path[0] - target_pos).length_squared() > threshold_sq) {
+			if (!_search_navgrid(route.path[route.goal_entry], target_pos, cache.local_path)) { return false; }
+
+			for (const V3 &waypoint : cache.local_path) {
+				_append_waypoint(joined, waypoint);
+			}
+			route_begin = route.goal_entry;
+		}
+
+		// Shared middle of the route.
+		for (size_t i = route_begin; i <= route.start_exit; i++) {
+			_append_waypoint(joined, route.path[i]);
+		}
+
+		// Start side, from our own position to where the route leaves the start cluster.
+		if (!_search_navgrid(start_position, route.path[route.start_exit], cache.local_path)) { return false; }
+
+		for (const V3 &waypoint : cache.local_path) {
+			_append_waypoint(joined, waypoint);
+		}
+
+		out_path.assign(joined.begin(), joined.end());
+		return true;
+	}
+
+	bool find_flyer_path(const V3 &start_position, const V3 &target_pos, OUT navmesh::Path &out_path) {
+
+		FlyerRouteCache &cache = get_flyer_route_cache();
+
+		const unsigned long long start_cluster = _get_flyer_cluster_key(start_position);
+		const unsigned long long goal_cluster = _get_flyer_cluster_key(target_pos);
+
+		// Within a single cluster the full search is already local.
+		if (start_cluster == goal_cluster) {
+			cache.stats.full_searches++;
+			return _search_navgrid(start_position, target_pos, out_path);
+		}
+
+		const unsigned long long key = _get_flyer_route_key(start_cluster, goal_cluster);
+		auto it = cache.routes.find(key);
+		if (it != cache.routes.end() && it->second.expire_time > timing::elapsed_time_seconds) {
+			if (_build_path_from_route(cache, it->second, start_position, target_pos, out_path)) {
+				cache.stats.shared_routes++;
+				return true;
+			}
+			cache.stats.failed_refines++;
+		}
+
+		cache.stats.full_searches++;
+		if (!_search_navgrid(start_position, target_pos, out_path)) { return false; }
+
+		_store_flyer_route(cache, key, start_cluster, goal_cluster, out_path);
+		return true;
+	}
+	void clear_flyer_route_cache() {
+		get_flyer_route_cache().routes.clear();
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <unordered_map>
+
+struct Agent;
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Hierarchical routes for flying bots.
+          Space is split into cubic clusters. The first flyer to path from one cluster to another runs the
+          full resolution navgrid search, and its path is cached as the route between those two clusters.
+          Later flyers going the same way only search locally: from their own position to where the route
+          leaves the start cluster, and from where it enters the goal cluster to their exact target. The
+          middle of the route is shared, so a swarm chasing the same player pays for one long search.
+
+          Routes expire after a few seconds, as the navgrid and the targets they were planned for change.
+
+    ====================================================================================
+*/
+
+    struct FlyerRoute {
+        navmesh::Path path;                 // Full resolution path, destination first like Movement::path.
+        size_t start_exit = 0;              // First waypoint (in walking order) outside the start cluster.
+        size_t goal_entry = 0;              // First waypoint (in walking order) inside the goal cluster.
+        double expire_time = 0.0;
+    };
+
+    struct FlyerRouteStats {
+        unsigned long long full_searches = 0;
+        unsigned long long shared_routes = 0;   // Paths built from a cached route.
+        unsigned long long failed_refines = 0;  // Cached route couldn't be joined locally, fell back to a full search.
+    };
+
+    struct FlyerRouteCache {
+        std::unordered_map<unsigned long long, FlyerRoute> routes;  // (start cluster, goal cluster) -> route.
+        navmesh::Path local_path;                                   // Scratch for the local searches.
+        FlyerRouteStats stats;
+    };
+
+    // Enables the cached cluster routes for flyers in move_towards.
+    extern bool hierarchical_flyer_paths;
+
+    FlyerRouteCache &get_flyer_route_cache();
+
+    // Writes a path from start_position to target_pos into out_path, returns false if none was found.
+    bool find_flyer_path(const V3 &start_position, const V3 &target_pos, OUT navmesh::Path &out_path);
+
+    void clear_flyer_route_cache();
+}
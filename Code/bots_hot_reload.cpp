@@ -0,0 +1,233 @@
+#include "bots.h"
+#include <filesystem>
+#include <fstream>
+#include <future>
+
+namespace bots {
+
+	const double HOT_RELOAD_CHECK_INTERVAL = 1.0;
+
+	typedef std::vector<BotDefinition> ShadowDefinitions;
+
+	// Result of a worker thread parse. Errors are logged by the main thread, the logger isn't guaranteed to be thread safe.
+	struct _ShadowParse {
+		ShadowDefinitions definitions;
+		std::vector<std::string> errors;
+	};
+
+	struct _HotReloadState {
+		std::string path = "";
+		std::filesystem::file_time_type last_write_time;
+		double next_check_time = 0;
+		std::future<std::unique_ptr<_ShadowParse>> pending_parse;
+	};
+
+	_HotReloadState &_get_hot_reload_state() {
+		static _HotReloadState state;
+		return state;
+	}
+
+	bool _get_last_write_time(const std::string &path, OUT std::filesystem::file_time_type &write_time) {
+		std::error_code error;
+		write_time = std::filesystem::last_write_time(path, error);
+		return !error;
+	}
+	std::unique_ptr<_ShadowParse> _parse_shadow_definitions(std::string path) {
+
+		// Runs on a worker thread, must not touch the live bot_definitions or log.
+		std::ifstream file(path, std::ios::binary);
+		if (!file) { return nullptr; }
+
+		std::string buf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		std::unique_ptr<_ShadowParse> shadow = std::make_unique<_ShadowParse>();
+		shadow->definitions.resize(BotType_COUNT);
+		parse_bot_definitions(buf, path, shadow->definitions.data(), &shadow->errors);
+		return shadow;
+	}
+	bool _interact_points_equal(const std::vector<InteractablePoint> &a, const std::vector<InteractablePoint> &b) {
+
+		if (a.size() != b.size()) { return false; }
+
+		for (size_t i = 0; i < a.size(); i++) {
+			if (a[i].hashed_joint_name != b[i].hashed_joint_name ||
+				a[i].interact_radius != b[i].interact_radius ||
+				a[i].pickup != b[i].pickup ||
+				a[i].ui_text != b[i].ui_text) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	unsigned int diff_bot_definitions(const BotDefinition &live, const BotDefinition &reloaded) {
+
+		unsigned int changes = BotDefinitionChange_None;
+
+		if (live.min_speed != reloaded.min_speed || live.max_speed != reloaded.max_speed ||
+			live.acceleration_multiplier != reloaded.acceleration_multiplier ||
+			live.deceleration_multiplier != reloaded.deceleration_multiplier ||
+			live.rotation_speed != reloaded.rotation_speed) {
+			changes |= BotDefinitionChange_Speed;
+		}
+		if (live.effect_multipliers != reloaded.effect_multipliers) {
+			changes |= BotDefinitionChange_Multipliers;
+		}
+		if (live.agent_scale != reloaded.agent_scale || live.agent_radius != reloaded.agent_radius || live.agent_height != reloaded.agent_height) {
+			changes |= BotDefinitionChange_Size;
+		}
+		if (live.flying != reloaded.flying || live.collidable != reloaded.collidable ||
+			live.show_hp_bar != reloaded.show_hp_bar || live.show_name != reloaded.show_name ||
+			live.snap_to_navmesh != reloaded.snap_to_navmesh || live.invulnerable != reloaded.invulnerable ||
+			live.hitboxes_active != reloaded.hitboxes_active || live.rotate_node_with_pitch != reloaded.rotate_node_with_pitch ||
+			live.rotate_with_steering != reloaded.rotate_with_steering || live.interactable != reloaded.interactable ||
+			live.avoidance_mode != reloaded.avoidance_mode) {
+			changes |= BotDefinitionChange_Flags;
+		}
+		if (live.min_hp != reloaded.min_hp || live.max_hp != reloaded.max_hp) {
+			changes |= BotDefinitionChange_Health;
+		}
+		if (live.name != reloaded.name || live.model != reloaded.model || live.material != reloaded.material) {
+			changes |= BotDefinitionChange_Visuals;
+		}
+		if (!_interact_points_equal(live.interact_points, reloaded.interact_points)) {
+			changes |= BotDefinitionChange_Interaction;
+		}
+		if (live.difficulty_type != reloaded.difficulty_type) {
+			changes |= BotDefinitionChange_Misc;
+		}
+		if (live.team != reloaded.team) {
+			changes |= BotDefinitionChange_Team;
+		}
+
+		return changes;
+	}
+	void reapply_bot_definition(Agent &agent, const BotDefinition &previous, const BotDefinition &current, unsigned int changes) {
+
+		BotState &bot_state = agent.bot_state;
+		Movement &movement = bot_state.movement;
+
+		if (changes & BotDefinitionChange_Speed) {
+
+			// Keep the bot at the same relative spot within the speed range it rolled on spawn.
+			double previous_range = previous.max_speed - previous.min_speed;
+			double t = previous_range > 0 ? CLAMP((movement.max_speed - previous.min_speed) / previous_range, 0.0, 1.0) : 0.0;
+
+			movement.max_speed = current.min_speed + (current.max_speed - current.min_speed) * t;
+			movement.acceleration_multiplier = current.acceleration_multiplier;
+			movement.deceleration_multiplier = current.deceleration_multiplier;
+			movement.rotation_speed = current.rotation_speed;
+			recompute_movement_speed(agent);
+		}
+
+		if (changes & BotDefinitionChange_Multipliers) {
+			for (int i = 0; i < StatusEffectCount; i++) {
+				movement.effect_multipliers[i] = current.effect_multipliers[i];
+			}
+		}
+
+		if (changes & BotDefinitionChange_Size) {
+			agent.agent_scale = current.agent_scale;
+		}
+
+		if (changes & BotDefinitionChange_Flags) {
+			agent.collidable = current.collidable;
+			agent.hitboxes_active = current.hitboxes_active;
+			agent.show_hp_bar = current.show_hp_bar;
+			agent.show_name = current.show_name;
+			agent.battle_state.rotate_node_with_pitch = current.rotate_node_with_pitch;
+			agent.battle_state.invulnerable = current.invulnerable;
+			movement.rotate_with_steering = current.rotate_with_steering;
+			movement.flying = current.flying;
+			movement.avoidance_mode = current.avoidance_mode;
+
+			// Knockback and pickups toggle navmesh snapping themselves, let them restore it once done.
+			if (!is_effect_active(agent, Knockback) && !is_effect_active(agent, HeldByAgent)) {
+				movement.snap_to_navmesh = current.snap_to_navmesh;
+			}
+		}
+
+		if (changes & BotDefinitionChange_Visuals) {
+			agent.username = current.name;
+		}
+
+		if (changes & BotDefinitionChange_Interaction) {
+			bot_state.interactable = current.interact_points.size();
+		}
+
+		if (changes & BotDefinitionChange_Misc) {
+			bot_state.difficulty_type = current.difficulty_type;
+		}
+	}
+
+	void watch_bot_definitions_file(const std::string &path) {
+
+		_HotReloadState &state = _get_hot_reload_state();
+		state.path = path;
+		state.next_check_time = 0;
+		_get_last_write_time(path, state.last_write_time);
+	}
+	void _swap_in_shadow_definitions(ShadowDefinitions &shadow) {
+
+		unsigned int type_changes[BotType_COUNT] = {};
+		bool any_changes = false;
+
+		for (unsigned int type = 0; type < BotType_COUNT; type++) {
+
+			// Types that are missing from the reloaded file keep their live definition.
+			if (!shadow[type].parsed) { continue; }
+
+			type_changes[type] = diff_bot_definitions(bot_definitions[type], shadow[type]);
+			any_changes |= type_changes[type] != BotDefinitionChange_None;
+		}
+
+		if (!any_changes) { return; }
+
+		// Callbacks are registered by each bot unit and are not part of the script.
+		for (unsigned int type = 0; type < BotType_COUNT; type++) {
+			if (!type_changes[type]) { continue; }
+
+			shadow[type].battle_callbacks = bot_definitions[type].battle_callbacks;
+			std::swap(bot_definitions[type], shadow[type]);
+			PRINT("[Bots] Reloaded definition for " + std::string(enum_to_case_string(static_cast<BotType>(type))));
+		}
+
+		// shadow now holds the previous definitions, which is what the bots were spawned with.
+		for (const auto &[id, agent] : gamestate::get_agents(netserver::state)) {
+			if (!agent || !agent->is_bot_server) { continue; }
+
+			BotType type = agent->bot_state.type;
+			if (type >= BotType_COUNT || !type_changes[type]) { continue; }
+
+			reapply_bot_definition(*agent, shadow[type], bot_definitions[type], type_changes[type]);
+		}
+	}
+	void update_bot_definitions_hot_reload() {
+
+		_HotReloadState &state = _get_hot_reload_state();
+		if (state.path.empty()) { return; }
+
+		// Pick up a finished parse, never block the tick waiting for one.
+		if (state.pending_parse.valid()) {
+			if (state.pending_parse.wait_for(std::chrono::seconds(0)) != std::future_status::ready) { return; }
+
+			std::unique_ptr<_ShadowParse> shadow = state.pending_parse.get();
+			if (shadow) {
+				for (const std::string &error : shadow->errors) {
+					LOG(error);
+				}
+				_swap_in_shadow_definitions(shadow->definitions);
+			}
+			return;
+		}
+
+		if (timing::elapsed_time_seconds < state.next_check_time) { return; }
+		state.next_check_time = timing::elapsed_time_seconds + HOT_RELOAD_CHECK_INTERVAL;
+
+		std::filesystem::file_time_type write_time;
+		if (!_get_last_write_time(state.path, write_time) || write_time == state.last_write_time) { return; }
+
+		state.last_write_time = write_time;
+		state.pending_parse = std::async(std::launch::async, _parse_shadow_definitions, state.path);
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+struct Agent;
+
+namespace bots {
+
+    struct BotDefinition;
+
+    // Groups of fields that differ between the live and reloaded definition of a BotType.
+    enum BotDefinitionChange : unsigned int {
+        BotDefinitionChange_None = 0,
+        BotDefinitionChange_Speed = 1 << 0,         // min/max speed, acceleration, deceleration, rotation speed
+        BotDefinitionChange_Multipliers = 1 << 1,   // StatusEffect multipliers
+        BotDefinitionChange_Size = 1 << 2,          // agent_scale, agent_radius, agent_height
+        BotDefinitionChange_Flags = 1 << 3,         // collidable, show_hp_bar, show_name, invulnerable etc.
+        BotDefinitionChange_Health = 1 << 4,        // min/max hp, only used for new spawns.
+        BotDefinitionChange_Visuals = 1 << 5,       // name, model, material
+        BotDefinitionChange_Interaction = 1 << 6,   // interact points
+        BotDefinitionChange_Misc = 1 << 7,          // difficulty type
+        BotDefinitionChange_Team = 1 << 8,          // team, only used for new spawns. Live bots stay registered with the AI manager under their old team.
+    };
+
+    unsigned int diff_bot_definitions(const BotDefinition &live, const BotDefinition &reloaded);
+
+    // Re-applies the changed tunables onto an already spawned bot, without re-rolling its spawn randomization.
+    void reapply_bot_definition(Agent &agent, const BotDefinition &previous, const BotDefinition &current, unsigned int changes);
+
+    // Starts watching the definition script. The file is re-parsed on a worker thread when it changes,
+    // and the result is swapped in from update_bot_definitions_hot_reload() in between ticks.
+    void watch_bot_definitions_file(const std::string &path);
+    void update_bot_definitions_hot_reload();
+}
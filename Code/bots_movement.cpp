@@ -77,7 +77,8 @@ namespace bots {
 		double distance_to_waypoint = feet_position.distance(next_waypoint);
 
 		// Define slowdown parameters
-		const double slowdown_radius = movement.effective_max_speed * 0.5;
+		const double effective_max_speed = get_effective_max_speed(movement);
+		const double slowdown_radius = effective_max_speed * 0.5;
 		const double slowdown_weight = 0.75; 
 		const double brake_weight = 3.0;
 		double base = 1.0 - CLAMP(slowdown_weight, 0, 1);
@@ -98,7 +99,7 @@ namespace bots {
 		t = sw::EaseInCubic(CLAMP(t, 0, 1));
 		double slowdown_factor = t * (base + (slowdown_weight * turn_sharpness));
 
-		V3 velocity_with_slowdown = dir_to_waypoint * movement.effective_max_speed * slowdown_factor;
+		V3 velocity_with_slowdown = dir_to_waypoint * effective_max_speed * slowdown_factor;
 		double brake_force = 0.8 + (turn_sharpness * brake_weight);
 
 		V3 deceleration = (velocity_with_slowdown - movement.velocity) * brake_force;
@@ -110,6 +111,11 @@ namespace bots {
 	}
 	void _send_root_motion_blend_value_to_client(const Agent &agent, const V3 &blend_velocity, bool stop_root_motion) {
 
+		if (batched_bot_replication) {
+			queue_root_motion_blend_value(agent, blend_velocity, stop_root_motion);
+			return;
+		}
+
 		messages::MsgEntityEvent pkg;
 		pkg.event_key = ENTITY_EVENT_ROOT_MOTION_BLEND_VALUE;
 		pkg.object_id = agent.player_id;
@@ -205,21 +211,35 @@ namespace bots {
 		// If we would use just the velocity (which is the last frame's velocity during the pre-update), we 
 		// will miss a slight amount of avoidance which causes bots to drift into eachother over time.
 
+		RootMotionCache &root_motion_cache = get_root_motion_cache();
+		root_motion_cache.agents.clear();
+
 		for (Agent *agent : agents) {
 			if (!agent) { continue; }
 
 			Movement &movement = agent->bot_state.movement;
 			movement.avoidance = V3::ZERO;
-			navmesh::clean_path(agents::get_feet_position(*agent), movement.path, MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD);
+			advance_path_cursor(movement, agents::get_feet_position(*agent));
 
 			const V3 navigation_direction = get_navigation_direction(*agent);
-
-			// Our desired velocity is always at full speed in the direction of where we need to navigate.
-			// TODO -> Scale desired_velocity based on proximity (we might want to slow down at certain threshold).
-			movement.desired_velocity = navigation_direction * movement.effective_max_speed;
+			const double effective_max_speed = get_effective_max_speed(movement);
+
+			// Our desired velocity is always at full speed in the direction of where we need to navigate,
+			// unless the smoothing stage capped our speed into the next corner.
+			movement.desired_velocity = navigation_direction * effective_max_speed * get_corner_speed_factor(*agent, effective_max_speed);
+
+			// Cached clips are sampled together for all bots after this loop.
+			if (movement.move_with_root_motion && can_sample_cached_root_motion(*agent)) {
+				agent->override_reconstructed_velocity = true;
+				agent->reconstructed_velocity_override = movement.desired_velocity;
+				root_motion_cache.agents.push_back(agent);
+				continue;
+			}
 
 			// When moving with root motion, we request a animation delta from the animation system.
 			if (movement.move_with_root_motion) {
+				advance_root_motion_clip(movement, dt);
+
 				V3 root_motion_delta = V3::ZERO;
 				double yaw_delta_dummy = 0.0;
 				get_current_anim_root_motion(*agent, movement.desired_velocity, root_motion_delta, yaw_delta_dummy);
@@ -235,23 +255,43 @@ namespace bots {
 				movement.velocity += velocity_change;
 			}
 
-			_clamp_to_max_speed(movement.velocity, movement.effective_max_speed);
+			_clamp_to_max_speed(movement.velocity, effective_max_speed);
+		}
+
+		if (root_motion_cache.agents.empty()) { return; }
+
+		static std::vector<V3> root_motion_deltas;
+		sample_root_motion_batch(root_motion_cache.agents, dt, root_motion_deltas);
+
+		for (size_t i = 0; i < root_motion_cache.agents.size(); i++) {
+			Movement &movement = root_motion_cache.agents[i]->bot_state.movement;
+			movement.velocity = root_motion_deltas[i] / dt;
+			_clamp_to_max_speed(movement.velocity, get_effective_max_speed(movement));
 		}
 	}
 	void update_avoidance_velocity(const std::vector<Agent *> &agents, double dt) {
 
 		std::vector<component::AvoidanceEntityData> avoid_entitites;
-		component::get_avoidance_entities(*game::level, avoid_entitites);
+		if (indexed_avoidance_entities) {
+			update_avoidance_entity_index();
+		} else {
+			component::get_avoidance_entities(*game::level, avoid_entitites);
+		}
 
 		constexpr double SPEED_DIFF_EPSILON = 0.001f;
 
+		// Bots in AvoidanceMode_Orca and AvoidanceMode_DensityField get their avoidance solved here and are only passive in the pairwise pass below.
+		update_orca_avoidance(agents, dt);
+		update_crowd_field_avoidance(agents);
+
 		// [Optimization] Calculate pairwise avoidance.
 		for (size_t a = 0; a < agents.size(); ++a) {
 			Agent *agent = agents[a];
 			if (!agent) { continue; }
 
 			Movement &movement_a = agent->bot_state.movement;
-			
+			const bool pairwise_a = movement_a.avoidance_enabled && movement_a.avoidance_mode == AvoidanceMode_Pairwise;
+
 			const double radius = get_avoidance_radius_by_type(*agent);
 
 			// +1 ensures we loop through each pair of agents exactly once.
@@ -260,6 +300,9 @@ namespace bots {
 				if (!other_agent || other_agent->team != agent->team) { continue; }
 
 				Movement &movement_b = other_agent->bot_state.movement;
+				const bool pairwise_b = movement_b.avoidance_enabled && movement_b.avoidance_mode == AvoidanceMode_Pairwise;
+				if (!pairwise_a && !pairwise_b) { continue; }
+
 				const double other_radius = get_avoidance_radius_by_type(*other_agent);
 
 				const V3 relative_vel = movement_b.velocity - movement_a.velocity;
@@ -291,20 +334,29 @@ namespace bots {
 				if (agent->bot_state.difficulty_type == other_agent->bot_state.difficulty_type) {
 
 					// Both has same priority to move and yield by half each.
-					movement_a.avoidance += avoidance * 0.5 * movement_a.avoidance_enabled;
-					movement_b.avoidance -= avoidance * 0.5 * movement_b.avoidance_enabled;
+					movement_a.avoidance += avoidance * 0.5 * pairwise_a;
+					movement_b.avoidance -= avoidance * 0.5 * pairwise_b;
 
 				} else if(agent->bot_state.difficulty_type > other_agent->bot_state.difficulty_type) {
 
 					// A has priority and B should yield.
-					movement_b.avoidance -= avoidance * 0.5 * movement_b.avoidance_enabled;
+					movement_b.avoidance -= avoidance * 0.5 * pairwise_b;
 				} else {
 					// Otherwise A must yield.
-					movement_a.avoidance += avoidance * 0.5 * movement_a.avoidance_enabled;
+					movement_a.avoidance += avoidance * 0.5 * pairwise_a;
 				}
 			}
 
 			// Checks for nearby level-avoidance entities that we should avoid.
+			if (indexed_avoidance_entities) {
+				const AvoidanceEntityIndex &index = get_avoidance_entity_index();
+				for (unsigned int entity_index : query_avoidance_entities(agent->battle_state.position, radius)) {
+					const component::AvoidanceEntityData &entity = index.entities[entity_index];
+					movement_a.avoidance += _get_obstacle_avoidance_repulsion(*agent, radius, entity.position, entity.radius);
+				}
+				continue;
+			}
+
 			for (const component::AvoidanceEntityData &entity : avoid_entitites) {
 				movement_a.avoidance += _get_obstacle_avoidance_repulsion(*agent, radius, entity.position, entity.radius);
 			}
@@ -315,13 +367,14 @@ namespace bots {
 		Movement &movement = agent.bot_state.movement;
 
 		movement.velocity += movement.avoidance;
-		_clamp_to_max_speed(movement.velocity, movement.effective_max_speed);
+		_clamp_to_max_speed(movement.velocity, get_effective_max_speed(movement));
 
 		// allow potential movement effects to adjust our velocity before we move.
 		update_status_effects(agent, dt, OUT movement.velocity);
+		movement.velocity = to_bot_precision(movement.velocity);
 
 		const V3 feet_position = agents::get_feet_position(agent);
-		V3 new_feet_position = feet_position + movement.velocity * dt;
+		V3 new_feet_position = to_bot_precision(feet_position + movement.velocity * dt);
 
 		// while active, we need to ensure the new position is on the navmesh.
 		if (movement.snap_to_navmesh && movement.velocity.length_squared() > 0.01) {
@@ -331,7 +384,7 @@ namespace bots {
 			const V3 SEARCH_AREA = V3(300.0, 300.0, 300.0);
 
 			if (get_nearest_navmesh_position(new_feet_position, movement.path_find_flags, snapped_feet_position, snapped_node_index, SEARCH_AREA)) {
-				new_feet_position = snapped_feet_position;
+				new_feet_position = to_bot_precision(snapped_feet_position);
 
 				//OPTIMIZATION: cache the result so that later pathfinding calls can re-use the nearest node.
 				agent.battle_state._nearest_navmesh_node_cached_args.position = new_feet_position;
@@ -385,6 +438,12 @@ namespace bots {
 				blended_direction = navigation_direction; 
 			}
 
+			// Rotated together with all other steering bots once every bot has moved.
+			if (fast_steering) {
+				queue_steering(agent, blended_direction);
+				return;
+			}
+
 			V3 rotate_target_position = agent.battle_state.position + blended_direction.normalized_safe() * 20.0;
 			rotate_towards(agent, rotate_target_position, dt);
 		}
@@ -419,13 +478,18 @@ namespace bots {
 		bots::Movement &movement = agent.bot_state.movement;
 
 		if (movement.flying) {
-			return path_find_navgrid(
-				gamestate::get_navgrid(netserver::state),
-				agent.battle_state.position,
-				target_pos,
-				movement.path,
-				true
-			);
+			bool found_path = hierarchical_flyer_paths
+				? find_flyer_path(agent.battle_state.position, target_pos, movement.path)
+				: path_find_navgrid(
+					gamestate::get_navgrid(netserver::state),
+					agent.battle_state.position,
+					target_pos,
+					movement.path,
+					true
+				);
+			smooth_bot_path(agent, agent.battle_state.position);
+			set_path_cursor(movement);
+			return found_path;
 		}
 
 		//OPTIMIZATION: only recompute the agent's nearest node if necessary. this makes it so that
@@ -448,7 +512,7 @@ namespace bots {
 			}
 		}
 
-		return path_find_navmesh(
+		bool found_path = path_find_navmesh(
 			args.position,
 			target_pos,
 			movement.path,
@@ -457,6 +521,78 @@ namespace bots {
 			agent.battle_state._nearest_navmesh_node_cached_result, //start_node
 			end_node
 		);
+		smooth_bot_path(agent, args.position);
+		set_path_cursor(movement);
+		return found_path;
+	}
+
+	void _stamp_path_cursor(Movement &movement) {
+
+		PathCursor &cursor = movement.path_cursor;
+		cursor.path_size = movement.path.size();
+		cursor.destination = movement.path.empty() ? V3::ZERO : movement.path[0];
+		cursor.next_waypoint = movement.path.empty() ? V3::ZERO : movement.path.back();
+	}
+	bool _is_path_cursor_current(const Movement &movement) {
+
+		const PathCursor &cursor = movement.path_cursor;
+		if (cursor.path_size != movement.path.size()) { return false; }
+
+		return movement.path.empty() ||
+			((movement.path[0] - cursor.destination).length_squared() == 0.0 && (movement.path.back() - cursor.next_waypoint).length_squared() == 0.0);
+	}
+	void set_path_cursor(Movement &movement) {
+
+		std::vector<BotScalar> &remaining_lengths = movement.path_cursor.remaining_lengths;
+		remaining_lengths.resize(movement.path.size());
+		_stamp_path_cursor(movement);
+		if (movement.path.empty()) { return; }
+
+		// Accumulate from the destination towards the next waypoint.
+		remaining_lengths[0] = 0.0;
+		for (size_t i = 1; i < movement.path.size(); i++) {
+			remaining_lengths[i] = remaining_lengths[i - 1] + movement.path[i].distance(movement.path[i - 1]);
+		}
+	}
+	bool advance_path_cursor(Movement &movement, const V3 &feet_position) {
+
+		std::vector<PathCorner> &corners = movement.path_cursor.corners;
+
+		// The path was changed without going thru move_towards (e.g. cleared or replaced), the corners belong to the old one.
+		if (!_is_path_cursor_current(movement)) {
+			set_path_cursor(movement);
+			corners.clear();
+		}
+
+		const double arrive_threshold_sq = MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD * MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD;
+		bool popped = false;
+		while (!movement.path.empty() && (movement.path.back() - feet_position).length_squared() <= arrive_threshold_sq) {
+			movement.path.pop_back();
+			movement.path_cursor.remaining_lengths.pop_back();
+			if (!corners.empty()) { corners.pop_back(); }
+			popped = true;
+		}
+
+		if (popped) {
+			_stamp_path_cursor(movement);
+		}
+
+		return !movement.path.empty();
+	}
+	double get_remaining_path_length(const Movement &movement, const V3 &position) {
+
+		if (movement.path.empty()) { return 0.0; }
+
+		double remaining_length = movement.path.back().distance(position);
+		if (_is_path_cursor_current(movement)) {
+			return remaining_length + movement.path_cursor.remaining_lengths.back();
+		}
+
+		// Cursor is stale, walk the path instead.
+		for (size_t i = 1; i < movement.path.size(); i++) {
+			remaining_length += movement.path[i].distance(movement.path[i - 1]);
+		}
+		return remaining_length;
 	}
 
 	void rotate_towards(Agent &agent, const V3 &target_pos, double dt, bool rotate_pitch) {
@@ -469,7 +605,7 @@ namespace bots {
 
 		// Increase rotation speed as our velocity aligns with the direction to the target.
 		const Movement &movement = agent.bot_state.movement;
-		double speed_pct = movement.velocity.length() / MAX(movement.effective_max_speed, 1.0);
+		double speed_pct = movement.velocity.length() / MAX(get_effective_max_speed(movement), 1.0);
 		double dot = movement.velocity.normalized_safe().dot(dir_to_target) * speed_pct;
 		double extra_rotation_speed = CLAMP(dot, 0, 1);
 
@@ -3,6 +3,31 @@
 
 namespace bots {
 
+    const size_t BOT_RESERVED_PATH_WAYPOINTS = 16; // Capacity reserved for paths on spawn, re-paths reuse it instead of reallocating.
+
+    enum AvoidanceMode : unsigned int {
+        AvoidanceMode_Pairwise = 0,             // Closest approach push per pair, see update_avoidance_velocity().
+        AvoidanceMode_Orca = 1,                 // Reciprocal velocity obstacles over the nearest neighbours, see update_orca_avoidance().
+        AvoidanceMode_DensityField = 2,         // Steers by a crowd density field instead of per pair, see update_crowd_field_avoidance().
+        AvoidanceMode_COUNT,
+    };
+
+    struct PathCorner {
+        double turn_angle = 0.0;                // Radians between the segment arriving at the waypoint and the one leaving it.
+        double approach_speed = 1.0;            // Fraction of effective max speed to arrive at the waypoint with.
+    };
+
+    // Cached lengths of the current path, built once when a path is assigned. Waypoints are consumed from the back,
+    // so remaining_lengths[i] (the path length from path[i] to the destination path[0]) stays valid as they are popped.
+    // path_size, destination and next_waypoint identify the path it was built for, any other path means the cursor is stale.
+    struct PathCursor {
+        std::vector<BotScalar> remaining_lengths;
+        std::vector<PathCorner> corners;        // Filled by the path smoothing stage, empty when it is disabled.
+        size_t path_size = 0;
+        V3 destination = V3::ZERO;
+        V3 next_waypoint = V3::ZERO;
+    };
+
     struct Movement {
         std::array<StatusEffect, StatusEffectCount> movement_effects = {};  // Currently holds all kinds of debuffs that can be applied to bots.
         std::array<double, StatusEffectCount> effect_multipliers;           // The effectivness that each debuff has on the bot.
@@ -15,7 +40,7 @@ namespace bots {
         V3 avoidance;                           // Avoidance velocity is used to negate any velocity that would cause a collision with another bot. (pre-calculated each frame within "update_avoidance_velocity()").
 
         double avoidance_radius = 0.0;          // TODO -> replace hardcoded stuff within get_avoidance_radius_by_type() and pass this thru script instead.
-        double effective_max_speed = 0.0;       // How fast we can currently move (modified by StatusEffects). NOTE: to change actual max speed you need to change "max_speed".
+        double effective_max_speed = 0.0;       // How fast we can currently move (modified by StatusEffects). NOTE: to change actual max speed you need to change "max_speed". Only a snapshot in closed form mode, read it thru get_effective_max_speed().
         double max_speed = 0.0;                 // How fast we can move. (does not get modified by StatusEffects).
         double rotation_speed = 1.0;            // How fast the bot should rotate.
         double acceleration_multiplier = 3.0;   // Controls how fast we ramp up to max speed and also affects the bots ability to turn (adjust its velocity to the next target position).
@@ -25,11 +50,19 @@ namespace bots {
         bool grounded = false;                  // Used within knockback physics simulation to track grounded state.
         bool snap_to_navmesh = true;            // Enables / Disables constrain to navmesh. (disable this temporary turing jumps or similar physics simulations).
         bool avoidance_enabled = true;          // Enables / Disabled avoidance movement.
+        AvoidanceMode avoidance_mode = AvoidanceMode_Pairwise; // How avoidance is solved while avoidance_enabled is set.
         bool rotate_with_steering = true;       // Enables / Disables rotation towards our next waypoint & velocity (blended).
         bool move_with_root_motion = false;     // Enables / Disables root motion movement. (Only affects our velocity / movement update if current playing animation has root motion).
         bool rotate_pitch_along_surface = false;// Rotate the pitch of the character when moving up/down slopes. (example was previous chargerm, OBS: haven't been used for quite some time).
 
+        V2 steering_facing = { 0, 1 };          // (sin yaw, cos yaw) cache of the fast steering kernel.
+        double steering_facing_yaw = 0.0;       // The rotation_yaw steering_facing was computed for.
+
+        unsigned long long root_motion_clip = 0;// Clip hash of the playing root motion animation, used to sample the root motion cache.
+        double root_motion_clip_time = 0.0;     // Playback time within root_motion_clip.
+
         navmesh::Path path;                     // Our current path that we follow. 
+        PathCursor path_cursor;                 // Remaining length per waypoint of path, see set_path_cursor().
         V3 last_safe_position = V3::ZERO;       // Used within knockback physics simulation to save the last valid "land" position in case of infinite falling.
 
 #ifdef PRIVATE_BUILD
@@ -44,6 +77,13 @@ namespace bots {
     bool move_towards(Agent &agent, Agent &target);
     bool move_towards(Agent &agent, const V3 &target_pos, unsigned int end_node = UINT_MAX /*optional: only useful if end_node has been pre-calculated*/);
 
+    // Rebuilds the cursor for movement.path, called whenever a new path is assigned.
+    void set_path_cursor(Movement &movement);
+    // Pops the waypoints we've arrived at, returns false if the path is done.
+    bool advance_path_cursor(Movement &movement, const V3 &feet_position);
+    // Length from position along the rest of the path, O(1).
+    double get_remaining_path_length(const Movement &movement, const V3 &position);
+
     void rotate_towards(Agent &agent, const V3 &target_pos, double dt, bool rotate_pitch = false);
     void rotate_with_surface_normal(Agent &agent, const V3 &surface_normal, const V3 &more_direction, double dt);
 
@@ -0,0 +1,360 @@
+#include "bots.h"
+
+namespace bots {
+
+	const double ORCA_TIME_HORIZON = 1.0;			// Seconds ahead that collisions with neighbours are avoided for.
+	const double ORCA_NEIGHBOUR_DISTANCE = 400.0;
+	const double ORCA_EPSILON = 0.00001;
+
+	struct _OrcaVec {
+		double x = 0.0;
+		double z = 0.0;
+	};
+	struct _OrcaLine {
+		_OrcaVec point;
+		_OrcaVec direction;
+	};
+
+	_OrcaVec operator+(const _OrcaVec &a, const _OrcaVec &b) { return { a.x + b.x, a.z + b.z }; }
+	_OrcaVec operator-(const _OrcaVec &a, const _OrcaVec &b) { return { a.x - b.x, a.z - b.z }; }
+	_OrcaVec operator*(const _OrcaVec &a, double s) { return { a.x * s, a.z * s }; }
+	_OrcaVec operator-(const _OrcaVec &a) { return { -a.x, -a.z }; }
+	double _dot(const _OrcaVec &a, const _OrcaVec &b) { return a.x * b.x + a.z * b.z; }
+	double _det(const _OrcaVec &a, const _OrcaVec &b) { return a.x * b.z - a.z * b.x; }
+	double _length_sq(const _OrcaVec &a) { return _dot(a, a); }
+	_OrcaVec _normalized(const _OrcaVec &a) {
+		const double length = sqrt(_length_sq(a));
+		return length > ORCA_EPSILON ? a * (1.0 / length) : _OrcaVec();
+	}
+
+	OrcaSolver &get_orca_solver() {
+		static OrcaSolver solver;
+		return solver;
+	}
+
+	// <---- Linear programs, in order of the ORCA paper ----> //
+
+	// Finds the optimal velocity on line line_index that satisfies all lines before it, within the speed circle.
+	bool _orca_linear_program_1(const _OrcaLine *lines, size_t line_index, double radius, const _OrcaVec &optimization_velocity, bool direction_opt, OUT _OrcaVec &result) {
+
+		const _OrcaLine &line = lines[line_index];
+		const double dot_product = _dot(line.point, line.direction);
+		const double discriminant = dot_product * dot_product + radius * radius - _length_sq(line.point);
+
+		// Max speed circle fully invalidates the line.
+		if (discriminant < 0.0) { return false; }
+
+		const double sqrt_discriminant = sqrt(discriminant);
+		double t_left = -dot_product - sqrt_discriminant;
+		double t_right = -dot_product + sqrt_discriminant;
+
+		for (size_t i = 0; i < line_index; i++) {
+			const double denominator = _det(line.direction, lines[i].direction);
+			const double numerator = _det(lines[i].direction, line.point - lines[i].point);
+
+			// Parallel lines, either all of this line is valid or none of it.
+			if (fabs(denominator) <= ORCA_EPSILON) {
+				if (numerator < 0.0) { return false; }
+				continue;
+			}
+
+			const double t = numerator / denominator;
+			if (denominator >= 0.0) {
+				t_right = MIN(t_right, t);
+			} else {
+				t_left = MAX(t_left, t);
+			}
+
+			if (t_left > t_right) { return false; }
+		}
+
+		if (direction_opt) {
+			result = line.point + line.direction * (_dot(optimization_velocity, line.direction) > 0.0 ? t_right : t_left);
+		} else {
+			const double t = _dot(line.direction, optimization_velocity - line.point);
+			result = line.point + line.direction * CLAMP(t, t_left, t_right);
+		}
+		return true;
+	}
+	// Returns line_count on success, otherwise the index of the line it failed on.
+	size_t _orca_linear_program_2(const _OrcaLine *lines, size_t line_count, double radius, const _OrcaVec &optimization_velocity, bool direction_opt, OUT _OrcaVec &result) {
+
+		if (direction_opt) {
+			result = optimization_velocity * radius;
+		} else if (_length_sq(optimization_velocity) > radius * radius) {
+			result = _normalized(optimization_velocity) * radius;
+		} else {
+			result = optimization_velocity;
+		}
+
+		for (size_t i = 0; i < line_count; i++) {
+			if (_det(lines[i].direction, lines[i].point - result) <= 0.0) { continue; }
+
+			// Result doesn't satisfy this line, find the best one that does.
+			const _OrcaVec previous_result = result;
+			if (!_orca_linear_program_1(lines, i, radius, optimization_velocity, direction_opt, result)) {
+				result = previous_result;
+				return i;
+			}
+		}
+		return line_count;
+	}
+	// Infeasible, pick the velocity that violates the lines from begin_line on the least.
+	void _orca_linear_program_3(const _OrcaLine *lines, size_t line_count, size_t begin_line, double radius, OUT _OrcaVec &result) {
+
+		double distance = 0.0;
+		_OrcaLine projected_lines[ORCA_MAX_NEIGHBOURS];
+
+		for (size_t i = begin_line; i < line_count; i++) {
+			if (_det(lines[i].direction, lines[i].point - result) <= distance) { continue; }
+
+			size_t projected_count = 0;
+			for (size_t j = 0; j < i; j++) {
+				_OrcaLine projected;
+				const double denominator = _det(lines[i].direction, lines[j].direction);
+
+				if (fabs(denominator) <= ORCA_EPSILON) {
+					// Same direction, line j doesn't constrain i further.
+					if (_dot(lines[i].direction, lines[j].direction) > 0.0) { continue; }
+					projected.point = (lines[i].point + lines[j].point) * 0.5;
+				} else {
+					projected.point = lines[i].point + lines[i].direction * (_det(lines[j].direction, lines[i].point - lines[j].point) / denominator);
+				}
+
+				projected.direction = _normalized(lines[j].direction - lines[i].direction);
+				projected_lines[projected_count++] = projected;
+			}
+
+			const _OrcaVec previous_result = result;
+			const _OrcaVec optimization_direction = { -lines[i].direction.z, lines[i].direction.x };
+			if (_orca_linear_program_2(projected_lines, projected_count, radius, optimization_direction, true, result) < projected_count) {
+				// Only fails on floating point errors, keep the last result.
+				result = previous_result;
+			}
+
+			distance = _det(lines[i].direction, lines[i].point - result);
+		}
+	}
+
+	// <---- Snapshot & neighbours ----> //
+
+	long long _get_orca_cell_key(int cell_x, int cell_z) {
+		return (long long)(((unsigned long long)(unsigned int)cell_x << 32) | (unsigned int)cell_z);
+	}
+	void _take_orca_snapshot(OrcaSolver &solver, const std::vector<Agent *> &agents) {
+
+		solver.agents.clear();
+		solver.solve_indices.clear();
+
+		for (Agent *agent : agents) {
+			if (!agent) { continue; }
+
+			const Movement &movement = agent->bot_state.movement;
+			if (movement.avoidance_enabled && movement.avoidance_mode == AvoidanceMode_Orca) {
+				solver.solve_indices.push_back((unsigned int)solver.agents.size());
+			}
+			solver.agents.push_back(agent);
+		}
+
+		if (solver.solve_indices.empty()) { return; }
+
+		const size_t count = solver.agents.size();
+		solver.position_x.resize(count);
+		solver.position_z.resize(count);
+		solver.velocity_x.resize(count);
+		solver.velocity_z.resize(count);
+		solver.radius.resize(count);
+		solver.max_speed.resize(count);
+		solver.team.resize(count);
+		solver.priority.resize(count);
+		solver.avoids.resize(count);
+
+		for (size_t i = 0; i < count; i++) {
+			const Agent &agent = *solver.agents[i];
+			const Movement &movement = agent.bot_state.movement;
+
+			solver.position_x[i] = agent.battle_state.position.x;
+			solver.position_z[i] = agent.battle_state.position.z;
+			solver.velocity_x[i] = movement.velocity.x;
+			solver.velocity_z[i] = movement.velocity.z;
+			solver.radius[i] = get_avoidance_radius_by_type(agent);
+			solver.max_speed[i] = get_effective_max_speed(movement);
+			solver.team[i] = agent.team;
+			solver.priority[i] = agent.bot_state.difficulty_type;
+			solver.avoids[i] = movement.avoidance_enabled;
+		}
+	}
+	void _insert_orca_neighbour(OrcaNeighbours &neighbours, unsigned int index, double distance_sq) {
+
+		// Kept sorted by (distance, index), so the k nearest don't depend on the order candidates are visited in.
+		size_t slot = neighbours.count;
+		while (slot > 0) {
+			const double other_distance_sq = neighbours.distances_sq[slot - 1];
+			if (other_distance_sq < distance_sq || (other_distance_sq == distance_sq && neighbours.indices[slot - 1] < index)) { break; }
+			slot--;
+		}
+
+		if (slot >= ORCA_MAX_NEIGHBOURS) { return; }
+
+		const size_t last = MIN(neighbours.count, ORCA_MAX_NEIGHBOURS - 1);
+		for (size_t i = last; i > slot; i--) {
+			neighbours.indices[i] = neighbours.indices[i - 1];
+			neighbours.distances_sq[i] = neighbours.distances_sq[i - 1];
+		}
+
+		neighbours.indices[slot] = index;
+		neighbours.distances_sq[slot] = distance_sq;
+		neighbours.count = MIN(neighbours.count + 1, ORCA_MAX_NEIGHBOURS);
+	}
+	void _find_orca_neighbours(OrcaSolver &solver) {
+
+		for (auto &cell : solver.cells) {
+			cell.second.clear();
+		}
+
+		for (unsigned int i = 0; i < solver.agents.size(); i++) {
+			const int cell_x = (int)floor(solver.position_x[i] / ORCA_NEIGHBOUR_DISTANCE);
+			const int cell_z = (int)floor(solver.position_z[i] / ORCA_NEIGHBOUR_DISTANCE);
+			solver.cells[_get_orca_cell_key(cell_x, cell_z)].push_back(i);
+		}
+
+		const double max_distance_sq = ORCA_NEIGHBOUR_DISTANCE * ORCA_NEIGHBOUR_DISTANCE;
+		solver.neighbours.resize(solver.solve_indices.size());
+
+		for (size_t s = 0; s < solver.solve_indices.size(); s++) {
+			const unsigned int index = solver.solve_indices[s];
+			OrcaNeighbours &neighbours = solver.neighbours[s];
+			neighbours.count = 0;
+
+			const int cell_x = (int)floor(solver.position_x[index] / ORCA_NEIGHBOUR_DISTANCE);
+			const int cell_z = (int)floor(solver.position_z[index] / ORCA_NEIGHBOUR_DISTANCE);
+
+			for (int x = cell_x - 1; x <= cell_x + 1; x++) {
+				for (int z = cell_z - 1; z <= cell_z + 1; z++) {
+					auto it = solver.cells.find(_get_orca_cell_key(x, z));
+					if (it == solver.cells.end()) { continue; }
+
+					for (unsigned int other : it->second) {
+						if (other == index || solver.team[other] != solver.team[index]) { continue; }
+
+						const double dx = solver.position_x[other] - solver.position_x[index];
+						const double dz = solver.position_z[other] - solver.position_z[index];
+						const double distance_sq = dx * dx + dz * dz;
+						if (distance_sq >= max_distance_sq) { continue; }
+
+						_insert_orca_neighbour(neighbours, other, distance_sq);
+					}
+				}
+			}
+		}
+	}
+
+	void solve_orca_velocity(const OrcaSolver &solver, size_t solve_index, double dt, OUT BotScalar &velocity_x, OUT BotScalar &velocity_z) {
+
+		const unsigned int index = solver.solve_indices[solve_index];
+		const OrcaNeighbours &neighbours = solver.neighbours[solve_index];
+
+		const _OrcaVec position = { solver.position_x[index], solver.position_z[index] };
+		const _OrcaVec velocity = { solver.velocity_x[index], solver.velocity_z[index] };
+		const double inv_time_horizon = 1.0 / ORCA_TIME_HORIZON;
+		const double inv_dt = 1.0 / MAX(dt, ORCA_EPSILON);
+
+		_OrcaLine lines[ORCA_MAX_NEIGHBOURS];
+		size_t line_count = 0;
+
+		for (size_t n = 0; n < neighbours.count; n++) {
+			const unsigned int other = neighbours.indices[n];
+
+			// Same rules as pairwise avoidance: the higher difficulty doesn't yield, equals yield by half each.
+			double responsibility = 0.5;
+			if (solver.priority[other] > solver.priority[index] || !solver.avoids[other]) {
+				responsibility = 1.0;
+			} else if (solver.priority[other] < solver.priority[index]) {
+				continue;
+			}
+
+			const _OrcaVec relative_position = _OrcaVec{ solver.position_x[other], solver.position_z[other] } - position;
+			const _OrcaVec relative_velocity = velocity - _OrcaVec{ solver.velocity_x[other], solver.velocity_z[other] };
+			const double distance_sq = _length_sq(relative_position);
+			const double combined_radius = solver.radius[index] + solver.radius[other];
+			const double combined_radius_sq = combined_radius * combined_radius;
+
+			_OrcaLine &line = lines[line_count];
+			_OrcaVec u;
+
+			if (distance_sq > combined_radius_sq) {
+				// Vector from the cutoff center to the relative velocity.
+				const _OrcaVec w = relative_velocity - relative_position * inv_time_horizon;
+				const double w_length_sq = _length_sq(w);
+				const double dot_product = _dot(w, relative_position);
+
+				if (dot_product < 0.0 && dot_product * dot_product > combined_radius_sq * w_length_sq) {
+					// Project on the cutoff circle.
+					const double w_length = sqrt(w_length_sq);
+					if (w_length <= ORCA_EPSILON) { continue; }
+
+					const _OrcaVec unit_w = w * (1.0 / w_length);
+					line.direction = { unit_w.z, -unit_w.x };
+					u = unit_w * (combined_radius * inv_time_horizon - w_length);
+				} else {
+					// Project on the closest leg of the velocity obstacle.
+					const double leg = sqrt(distance_sq - combined_radius_sq);
+					if (_det(relative_position, w) > 0.0) {
+						line.direction = _OrcaVec{ relative_position.x * leg - relative_position.z * combined_radius,
+							relative_position.x * combined_radius + relative_position.z * leg } * (1.0 / distance_sq);
+					} else {
+						line.direction = -_OrcaVec{ relative_position.x * leg + relative_position.z * combined_radius,
+							-relative_position.x * combined_radius + relative_position.z * leg } * (1.0 / distance_sq);
+					}
+					u = line.direction * _dot(relative_velocity, line.direction) - relative_velocity;
+				}
+			} else {
+				// Already overlapping, resolve it within this tick.
+				const _OrcaVec w = relative_velocity - relative_position * inv_dt;
+				const double w_length = sqrt(_length_sq(w));
+				if (w_length <= ORCA_EPSILON) { continue; }
+
+				const _OrcaVec unit_w = w * (1.0 / w_length);
+				line.direction = { unit_w.z, -unit_w.x };
+				u = unit_w * (combined_radius * inv_dt - w_length);
+			}
+
+			line.point = velocity + u * responsibility;
+			line_count++;
+		}
+
+		_OrcaVec result;
+		const double max_speed = solver.max_speed[index];
+		const size_t failed_line = _orca_linear_program_2(lines, line_count, max_speed, velocity, false, result);
+		if (failed_line < line_count) {
+			_orca_linear_program_3(lines, line_count, failed_line, max_speed, result);
+		}
+
+		velocity_x = result.x;
+		velocity_z = result.z;
+	}
+	void update_orca_avoidance(const std::vector<Agent *> &agents, double dt) {
+
+		OrcaSolver &solver = get_orca_solver();
+
+		_take_orca_snapshot(solver, agents);
+		if (solver.solve_indices.empty()) { return; }
+
+		_find_orca_neighbours(solver);
+
+		solver.solved_velocity_x.resize(solver.solve_indices.size());
+		solver.solved_velocity_z.resize(solver.solve_indices.size());
+
+		// Independent per bot, this loop is what would be split into jobs.
+		for (size_t s = 0; s < solver.solve_indices.size(); s++) {
+			solve_orca_velocity(solver, s, dt, solver.solved_velocity_x[s], solver.solved_velocity_z[s]);
+		}
+
+		// update_movement adds avoidance onto the intended velocity, so store the difference.
+		for (size_t s = 0; s < solver.solve_indices.size(); s++) {
+			const unsigned int index = solver.solve_indices[s];
+			Movement &movement = solver.agents[index]->bot_state.movement;
+			movement.avoidance = V3(solver.solved_velocity_x[s] - solver.velocity_x[index], 0.0, solver.solved_velocity_z[s] - solver.velocity_z[index]);
+		}
+	}
+}
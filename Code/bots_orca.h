@@ -0,0 +1,57 @@
+#pragma once
+#include <unordered_map>
+
+struct Agent;
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          ORCA (optimal reciprocal collision avoidance) for bots with AvoidanceMode_Orca.
+          Each bot takes a half plane of allowed velocities from each of its nearest neighbours,
+          and the velocity closest to the one it intended is found with a small 2D linear program in xz.
+          Both sides of a pair take half of the avoidance, so bots walking into each other choose
+          opposite sides instead of pushing back and forth.
+
+          All bots are first copied into a snapshot. Each bot is then solved from the snapshot and
+          its own neighbour list only, so the solve is deterministic regardless of order and can be split
+          across threads. Neighbours are picked by distance, and equal distances are broken by index.
+
+    ====================================================================================
+*/
+
+    const size_t ORCA_MAX_NEIGHBOURS = 10;
+
+    struct OrcaNeighbours {
+        unsigned int indices[ORCA_MAX_NEIGHBOURS];      // Into the snapshot, nearest first.
+        double distances_sq[ORCA_MAX_NEIGHBOURS];
+        size_t count = 0;
+    };
+
+    // Snapshot of every bot taking part in avoidance this tick, as seen from the start of the ORCA pass.
+    struct OrcaSolver {
+        std::vector<Agent *> agents;
+        std::vector<BotScalar> position_x, position_z;
+        std::vector<BotScalar> velocity_x, velocity_z;
+        std::vector<BotScalar> radius;
+        std::vector<BotScalar> max_speed;
+        std::vector<int> team;
+        std::vector<int> priority;                      // DifficultyType, the higher one doesn't yield.
+        std::vector<unsigned char> avoids;              // Whether the bot takes its own half of the avoidance.
+
+        std::vector<unsigned int> solve_indices;        // Snapshot indices of the bots in AvoidanceMode_Orca.
+        std::vector<OrcaNeighbours> neighbours;         // Per solve index.
+        std::vector<BotScalar> solved_velocity_x, solved_velocity_z;
+
+        std::unordered_map<long long, std::vector<unsigned int>> cells;     // Neighbour search grid, keeps its capacity.
+    };
+
+    OrcaSolver &get_orca_solver();
+
+    // Writes Movement::avoidance of every bot in AvoidanceMode_Orca, called from update_avoidance_velocity().
+    void update_orca_avoidance(const std::vector<Agent *> &agents, double dt);
+
+    // Solves a single bot against the snapshot, only reads the solver and writes nothing shared.
+    void solve_orca_velocity(const OrcaSolver &solver, size_t solve_index, double dt, OUT BotScalar &velocity_x, OUT BotScalar &velocity_z);
+}
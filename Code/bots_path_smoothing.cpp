@@ -0,0 +1,134 @@
+#include "bots.h"
+
+namespace bots {
+
+	const double PATH_SMOOTHING_COLLINEAR_COS = 0.999;
+	const int PATH_SMOOTHING_MAX_TRACES = 16;
+	const double PATH_CORNER_SLOWDOWN_WEIGHT = 0.75;	// A full U-turn is approached at 25% speed.
+	const double PATH_CORNER_SLOWDOWN_RADIUS = 0.5;		// Seconds at effective max speed before a corner that we start slowing down.
+
+	bool smooth_bot_paths = false;
+
+	void _prune_path(navmesh::Path &path) {
+
+		if (path.size() < 3) { return; }
+
+		// path[0] is the destination and always kept, we build the pruned path in place from there.
+		const double min_distance_sq = MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD * MOVEMENT_WAYPOINT_ARRIVE_THRESHOLD;
+		size_t kept = 1;
+
+		for (size_t i = 1; i < path.size(); i++) {
+			const V3 &waypoint = path[i];
+			const V3 &previous = path[kept - 1];
+
+			if ((waypoint - previous).length_squared() < min_distance_sq) { continue; }
+
+			// Replace the last kept waypoint if it lies on the straight line from here to the one before it.
+			if (kept >= 2) {
+				const V3 dir_in = (path[kept - 1] - waypoint).normalized_safe();
+				const V3 dir_out = (path[kept - 2] - path[kept - 1]).normalized_safe();
+				if (dir_in.dot(dir_out) > PATH_SMOOTHING_COLLINEAR_COS) {
+					kept--;
+				}
+			}
+
+			path[kept++] = waypoint;
+		}
+
+		path.resize(kept);
+	}
+	void _string_pull_path(navmesh::Path &path, const V3 &start_position) {
+
+		if (path.size() < 2) { return; }
+
+		static navmesh::Path pulled;
+		pulled.clear();
+
+		// Walk from the start towards the destination and skip every waypoint the current anchor can see past.
+		V3 anchor = start_position;
+		int traces = 0;
+		size_t i = path.size() - 1;
+
+		while (i > 0) {
+			if (traces >= PATH_SMOOTHING_MAX_TRACES) {
+				pulled.push_back(path[i]);
+				i--;
+				continue;
+			}
+
+			traces++;
+			if (bot_trace_line_of_sight(anchor, path[i - 1])) {
+				i--;
+				continue;
+			}
+
+			anchor = path[i];
+			pulled.push_back(path[i]);
+			i--;
+		}
+		pulled.push_back(path[0]);
+
+		// pulled is in walking order, the path wants the destination first.
+		path.assign(pulled.rbegin(), pulled.rend());
+	}
+	void _annotate_path_corners(Movement &movement, const V3 &start_position) {
+
+		const navmesh::Path &path = movement.path;
+		std::vector<PathCorner> &corners = movement.path_cursor.corners;
+		corners.resize(path.size());
+
+		for (size_t i = 0; i < path.size(); i++) {
+			PathCorner &corner = corners[i];
+			corner = PathCorner();
+
+			// The destination is arrived at, not turned around.
+			if (i == 0) { continue; }
+
+			const V3 &from = i + 1 < path.size() ? path[i + 1] : start_position;
+			V3 dir_in = path[i] - from;
+			V3 dir_out = path[i - 1] - path[i];
+			if (!movement.flying) {
+				dir_in.y = 0.0;
+				dir_out.y = 0.0;
+			}
+
+			const double dot = CLAMP(dir_in.normalized_safe().dot(dir_out.normalized_safe()), -1.0, 1.0);
+			corner.turn_angle = acos(dot);
+			corner.approach_speed = 1.0 - PATH_CORNER_SLOWDOWN_WEIGHT * (corner.turn_angle / TRIG_PI);
+		}
+	}
+
+	void smooth_bot_path(Agent &agent, const V3 &start_position) {
+
+		Movement &movement = agent.bot_state.movement;
+
+		if (!smooth_bot_paths) {
+			movement.path_cursor.corners.clear();
+			return;
+		}
+
+		if (movement.flying) {
+			_string_pull_path(movement.path, start_position);
+		} else {
+			_prune_path(movement.path);
+		}
+
+		_annotate_path_corners(movement, start_position);
+	}
+	double get_corner_speed_factor(Agent &agent, double effective_max_speed) {
+
+		const Movement &movement = agent.bot_state.movement;
+		if (movement.path.size() < 2 || movement.path_cursor.corners.size() != movement.path.size()) { return 1.0; }
+
+		const PathCorner &corner = movement.path_cursor.corners.back();
+		if (corner.approach_speed >= 1.0) { return 1.0; }
+
+		const double slowdown_radius = effective_max_speed * PATH_CORNER_SLOWDOWN_RADIUS;
+		const double distance_sq = (movement.path.back() - agents::get_feet_position(agent)).length_squared();
+		if (distance_sq >= slowdown_radius * slowdown_radius) { return 1.0; }
+
+		// Ease from full speed at the edge of the radius down to the approach speed at the corner.
+		const double t = sw::EaseInCubic(CLAMP(sqrt(distance_sq) / MAX(slowdown_radius, 1.0), 0, 1));
+		return corner.approach_speed + (1.0 - corner.approach_speed) * t;
+	}
+}
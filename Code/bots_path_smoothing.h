@@ -0,0 +1,29 @@
+#pragma once
+
+struct Agent;
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Path post-processing, run once whenever move_towards assigns a new path.
+          Flyer paths come off the navgrid as cell by cell staircases, so they are string pulled with
+          line of sight traces. Navmesh paths are already funneled and only get collinear and bunched up
+          waypoints removed, as a level trace says nothing about whether the straight line is walkable.
+
+          Each remaining waypoint then gets its turn angle and the speed to approach it with stored in
+          the PathCursor, so update_velocity only has to scale towards a precomputed cap near a corner.
+
+    ====================================================================================
+*/
+
+    // Enables path smoothing and corner speed caps.
+    extern bool smooth_bot_paths;
+
+    // start_position is where the path was searched from.
+    void smooth_bot_path(Agent &agent, const V3 &start_position);
+
+    // Multiplier for the desired speed given the distance to the next corner, 1.0 when not slowing down.
+    double get_corner_speed_factor(Agent &agent, double effective_max_speed);
+}
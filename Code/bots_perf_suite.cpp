@@ -0,0 +1,361 @@
+#include "bots.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#ifdef PRIVATE_BUILD
+
+namespace bots {
+
+	const double BOT_PERF_DT = 1.0 / 30.0;
+	const int BOT_PERF_REPATH_INTERVAL = 10;
+	const char *BOT_PERF_PHASE_NAMES[BotPerfPhase_COUNT] = { "pre", "update", "post" };
+
+	V3 _get_bots_centroid(const std::vector<Agent *> &bots) {
+		V3 centroid = V3::ZERO;
+		for (Agent *bot : bots) {
+			centroid += bot->battle_state.position;
+		}
+		return bots.empty() ? centroid : centroid / (double)bots.size();
+	}
+
+	void _setup_idle(const std::vector<Agent *> &bots) {
+		for (Agent *bot : bots) {
+			bot->bot_state.movement.path.clear();
+			bot->bot_state.movement.velocity = V3::ZERO;
+		}
+	}
+	void _tick_chase(const std::vector<Agent *> &bots, int tick) {
+
+		if (tick % BOT_PERF_REPATH_INTERVAL) { return; }
+
+		const std::vector<Agent *> &players = gamestate::get_ai_manager(netserver::state).alive_active_players;
+		for (Agent *bot : bots) {
+			if (!players.empty() && players.front()) {
+				move_towards(*bot, *players.front());
+			} else {
+				// No players around, chase a point on the other side of the group instead.
+				move_towards(*bot, bot->battle_state.position + (_get_bots_centroid(bots) - bot->battle_state.position) * 2.0);
+			}
+		}
+	}
+	void _setup_aoe_knockback(const std::vector<Agent *> &bots) {
+
+		const V3 center = _get_bots_centroid(bots);
+		for (Agent *bot : bots) {
+			V3 away = (bot->battle_state.position - center);
+			away.y = 0.0;
+			apply_knockback(*bot, away.normalized_safe() * 600.0 + V3(0, 400, 0));
+		}
+	}
+	void _setup_mass_timestop(const std::vector<Agent *> &bots) {
+		for (Agent *bot : bots) {
+			apply_timestop(*bot, 5.0);
+		}
+	}
+	void _tick_flyers(const std::vector<Agent *> &bots, int tick) {
+
+		if (tick % BOT_PERF_REPATH_INTERVAL) { return; }
+
+		for (Agent *bot : bots) {
+			V3 offset(bot_rand(2000) - 1000.0, bot_rand(400) - 200.0, bot_rand(2000) - 1000.0);
+			move_towards(*bot, bot->battle_state.position + offset);
+		}
+	}
+
+	const std::vector<BotPerfScenario> &get_bot_perf_scenarios() {
+		static const std::vector<BotPerfScenario> scenarios = {
+			{ "idle_2000",			2000,	300,	false,	_setup_idle,			nullptr },
+			{ "chase_500",			500,	300,	false,	nullptr,				_tick_chase },
+			{ "aoe_knockback_200",	200,	150,	false,	_setup_aoe_knockback,	nullptr },
+			{ "mass_timestop",		2000,	150,	false,	_setup_mass_timestop,	nullptr },
+			{ "flyers_navgrid_50",	50,		300,	true,	nullptr,				_tick_flyers },
+		};
+		return scenarios;
+	}
+
+	struct _BotPerfSnapshot {
+		V3 position;
+		double rotation_yaw = 0.0;
+	};
+	void _restore_bots(const std::vector<Agent *> &bots, const std::vector<_BotPerfSnapshot> &snapshots) {
+		for (size_t i = 0; i < bots.size(); i++) {
+			Agent &bot = *bots[i];
+			for (int type = 0; type < StatusEffectCount; type++) {
+				clear_status_effect(bot, static_cast<StatusEffectType>(type));
+			}
+
+			bot.battle_state.position = snapshots[i].position;
+			bot.battle_state.rotation_yaw = snapshots[i].rotation_yaw;
+			bot.bot_state.movement.path.clear();
+			bot.bot_state.movement.velocity = V3::ZERO;
+		}
+	}
+	double _get_percentile(std::vector<double> &samples, double percentile) {
+		if (samples.empty()) { return 0.0; }
+
+		std::sort(samples.begin(), samples.end());
+		return samples[(size_t)(percentile * (samples.size() - 1))];
+	}
+	double _get_elapsed_ms(std::chrono::high_resolution_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+	BotPerfResult _run_bot_perf_scenario(const BotPerfScenario &scenario, const std::vector<Agent *> &bot_pool) {
+
+		BotPerfResult result;
+		result.scenario = scenario.name;
+
+		std::vector<Agent *> bots;
+		for (Agent *bot : bot_pool) {
+			if (bots.size() >= scenario.bot_count) { break; }
+			if (!bot || !bot->battle_state.alive || bot->bot_state.movement.flying != scenario.flying) { continue; }
+			bots.push_back(bot);
+		}
+
+		if (bots.size() < scenario.bot_count) {
+			PRINT("[Bots] Skipping perf scenario " + result.scenario + ", needs " + toString(scenario.bot_count) + " bots, have " + toString(bots.size()));
+			result.skipped = true;
+			return result;
+		}
+
+		std::vector<_BotPerfSnapshot> snapshots(bots.size());
+		for (size_t i = 0; i < bots.size(); i++) {
+			snapshots[i].position = bots[i]->battle_state.position;
+			snapshots[i].rotation_yaw = bots[i]->battle_state.rotation_yaw;
+		}
+
+		const double start_time = timing::elapsed_time_seconds;
+		if (scenario.setup) { scenario.setup(bots); }
+
+		std::vector<double> samples[BotPerfPhase_COUNT];
+		for (int tick = 0; tick < scenario.ticks; tick++) {
+
+			if (scenario.tick) { scenario.tick(bots, tick); }
+			timing::elapsed_time_seconds += BOT_PERF_DT;
+
+			auto phase_start = std::chrono::high_resolution_clock::now();
+			update_bots_pre(bots, BOT_PERF_DT);
+			samples[BotPerfPhase_Pre].push_back(_get_elapsed_ms(phase_start));
+
+			phase_start = std::chrono::high_resolution_clock::now();
+			update_bots(bots, BOT_PERF_DT, (unsigned int)tick);
+			samples[BotPerfPhase_Update].push_back(_get_elapsed_ms(phase_start));
+
+			phase_start = std::chrono::high_resolution_clock::now();
+			update_bots_post(bots, BOT_PERF_DT);
+			samples[BotPerfPhase_Post].push_back(_get_elapsed_ms(phase_start));
+		}
+
+		timing::elapsed_time_seconds = start_time;
+		_restore_bots(bots, snapshots);
+
+		for (int phase = 0; phase < BotPerfPhase_COUNT; phase++) {
+			result.p50[phase] = _get_percentile(samples[phase], 0.5);
+			result.p99[phase] = _get_percentile(samples[phase], 0.99);
+		}
+		return result;
+	}
+
+	std::vector<BotPerfResult> run_bot_perf_scenarios(const std::vector<Agent *> &bot_pool) {
+
+		std::vector<BotPerfResult> results;
+		for (const BotPerfScenario &scenario : get_bot_perf_scenarios()) {
+			results.push_back(_run_bot_perf_scenario(scenario, bot_pool));
+
+			const BotPerfResult &result = results.back();
+			if (result.skipped) { continue; }
+
+			for (int phase = 0; phase < BotPerfPhase_COUNT; phase++) {
+				PRINT("[Bots] " + result.scenario + " " + BOT_PERF_PHASE_NAMES[phase] + ": p50 " + toString(result.p50[phase]) + "ms, p99 " + toString(result.p99[phase]) + "ms");
+			}
+		}
+		return results;
+	}
+
+	bool write_bot_perf_baseline(const std::string &path, const std::vector<BotPerfResult> &results) {
+
+		std::ofstream file(path);
+		if (!file) {
+			LOG("[Bots] Failed to write perf baseline " + path);
+			return false;
+		}
+
+		for (const BotPerfResult &result : results) {
+			if (result.skipped) { continue; }
+
+			for (int phase = 0; phase < BotPerfPhase_COUNT; phase++) {
+				file << result.scenario << " " << BOT_PERF_PHASE_NAMES[phase] << " " << result.p50[phase] << " " << result.p99[phase] << "\n";
+			}
+		}
+		return true;
+	}
+	bool compare_bot_perf_baseline(const std::string &path, const std::vector<BotPerfResult> &results, double tolerance) {
+
+		std::ifstream file(path);
+		if (!file) {
+			LOG("[Bots] Failed to read perf baseline " + path);
+			return false;
+		}
+
+		bool passed = true;
+		size_t compared = 0;
+		std::vector<std::string> unmeasured;
+		std::string line;
+		while (std::getline(file, line)) {
+
+			std::istringstream stream(line);
+			std::string scenario, phase_name;
+			double baseline_p50 = 0.0, baseline_p99 = 0.0;
+			if (!(stream >> scenario >> phase_name >> baseline_p50 >> baseline_p99)) { continue; }
+
+			// A baseline entry that wasn't measured this run must not let the gate pass by default.
+			auto result = std::find_if(results.begin(), results.end(), [&](const BotPerfResult &r) { return r.scenario == scenario; });
+			if (result == results.end() || result->skipped) {
+				if (std::find(unmeasured.begin(), unmeasured.end(), scenario) == unmeasured.end()) {
+					PRINT("[Bots] UNMEASURED " + scenario + ": " + (result == results.end() ? "no such scenario" : "skipped, not enough (flying) bots in the session"));
+					unmeasured.push_back(scenario);
+				}
+				passed = false;
+				continue;
+			}
+			compared++;
+
+			for (int phase = 0; phase < BotPerfPhase_COUNT; phase++) {
+				if (phase_name != BOT_PERF_PHASE_NAMES[phase]) { continue; }
+
+				const bool p50_regressed = result->p50[phase] > baseline_p50 * (1.0 + tolerance);
+				const bool p99_regressed = result->p99[phase] > baseline_p99 * (1.0 + tolerance);
+				if (!p50_regressed && !p99_regressed) { continue; }
+
+				PRINT("[Bots] REGRESSION " + scenario + " " + phase_name + ": p50 " + toString(baseline_p50) + " -> " + toString(result->p50[phase]) +
+					"ms, p99 " + toString(baseline_p99) + " -> " + toString(result->p99[phase]) + "ms");
+				passed = false;
+			}
+		}
+
+		if (!compared) {
+			PRINT("[Bots] Perf baseline " + path + " has no entries that were measured this run");
+			passed = false;
+		}
+		return passed;
+	}
+	bool run_bot_perf_suite(const std::vector<Agent *> &bot_pool, const std::string &baseline_path, bool update_baseline, double tolerance) {
+
+		std::vector<BotPerfResult> results = run_bot_perf_scenarios(bot_pool);
+		if (update_baseline) {
+			return write_bot_perf_baseline(baseline_path, results);
+		}
+
+		bool passed = compare_bot_perf_baseline(baseline_path, results, tolerance);
+		PRINT(std::string("[Bots] Perf suite ") + (passed ? "passed" : "FAILED"));
+		return passed;
+	}
+
+	const char *BOT_AVOIDANCE_MODE_NAMES[AvoidanceMode_COUNT] = { "pairwise", "orca", "density_field" };
+
+	double _get_min_separation(const std::vector<Agent *> &bots) {
+
+		double min_separation = DBL_MAX;
+		for (size_t a = 0; a < bots.size(); a++) {
+			const double radius = get_avoidance_radius_by_type(*bots[a]);
+			for (size_t b = a + 1; b < bots.size(); b++) {
+				const double combined_radius = radius + get_avoidance_radius_by_type(*bots[b]);
+				if (combined_radius <= 0.0) { continue; }
+
+				V3 offset = bots[b]->battle_state.position - bots[a]->battle_state.position;
+				offset.y = 0.0;
+				min_separation = MIN(min_separation, offset.length() / combined_radius);
+			}
+		}
+		return min_separation;
+	}
+	BotAvoidanceBenchmarkResult _run_avoidance_mode(const std::vector<Agent *> &bots, AvoidanceMode mode, int ticks) {
+
+		BotAvoidanceBenchmarkResult result;
+		result.mode = mode;
+
+		std::vector<_BotPerfSnapshot> snapshots(bots.size());
+		std::vector<AvoidanceMode> previous_modes(bots.size());
+		for (size_t i = 0; i < bots.size(); i++) {
+			snapshots[i].position = bots[i]->battle_state.position;
+			snapshots[i].rotation_yaw = bots[i]->battle_state.rotation_yaw;
+			previous_modes[i] = bots[i]->bot_state.movement.avoidance_mode;
+			bots[i]->bot_state.movement.avoidance_mode = mode;
+		}
+
+		const V3 center = _get_bots_centroid(bots);
+		for (Agent *bot : bots) {
+			move_towards(*bot, center * 2.0 - bot->battle_state.position);
+		}
+
+		std::vector<double> samples;
+		std::vector<V3> previous_velocities(bots.size(), V3::ZERO);
+		double heading_change = 0.0;
+		size_t heading_samples = 0;
+		double min_separation = DBL_MAX;
+
+		for (int tick = 0; tick < ticks; tick++) {
+			update_velocity(bots, BOT_PERF_DT);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			update_avoidance_velocity(bots, BOT_PERF_DT);
+			samples.push_back(_get_elapsed_ms(start));
+
+			for (size_t i = 0; i < bots.size(); i++) {
+				update_movement(*bots[i], BOT_PERF_DT);
+
+				V3 velocity = bots[i]->bot_state.movement.velocity;
+				velocity.y = 0.0;
+				if (velocity.length_squared() > 1.0 && previous_velocities[i].length_squared() > 1.0) {
+					heading_change += acos(CLAMP(velocity.normalized().dot(previous_velocities[i].normalized()), -1.0, 1.0));
+					heading_samples++;
+				}
+				previous_velocities[i] = velocity;
+			}
+
+			// Pairwise distances are as expensive as pairwise avoidance, only sample them every few ticks.
+			if (tick % BOT_PERF_REPATH_INTERVAL == 0) {
+				min_separation = MIN(min_separation, _get_min_separation(bots));
+			}
+		}
+
+		_restore_bots(bots, snapshots);
+		for (size_t i = 0; i < bots.size(); i++) {
+			bots[i]->bot_state.movement.avoidance_mode = previous_modes[i];
+		}
+
+		result.p50 = _get_percentile(samples, 0.5);
+		result.p99 = _get_percentile(samples, 0.99);
+		result.bots_per_ms = result.p50 > 0.0 ? bots.size() / result.p50 : 0.0;
+		result.jitter = heading_samples ? heading_change / heading_samples : 0.0;
+		result.min_separation = min_separation;
+		return result;
+	}
+	std::vector<BotAvoidanceBenchmarkResult> run_avoidance_mode_benchmark(const std::vector<Agent *> &bot_pool, size_t bot_count, int ticks) {
+
+		std::vector<Agent *> bots;
+		for (Agent *bot : bot_pool) {
+			if (bots.size() >= bot_count) { break; }
+			if (!bot || !bot->battle_state.alive || bot->bot_state.movement.flying || !bot->bot_state.movement.avoidance_enabled) { continue; }
+			bots.push_back(bot);
+		}
+
+		std::vector<BotAvoidanceBenchmarkResult> results;
+		for (int mode = 0; mode < AvoidanceMode_COUNT; mode++) {
+			if (bots.size() < bot_count) {
+				PRINT("[Bots] Skipping avoidance benchmark, needs " + toString(bot_count) + " ground bots, have " + toString(bots.size()));
+				results.emplace_back().skipped = true;
+				continue;
+			}
+
+			results.push_back(_run_avoidance_mode(bots, static_cast<AvoidanceMode>(mode), ticks));
+
+			const BotAvoidanceBenchmarkResult &result = results.back();
+			PRINT("[Bots] Avoidance " + std::string(BOT_AVOIDANCE_MODE_NAMES[mode]) + ": p50 " + toString(result.p50) + "ms, p99 " + toString(result.p99) +
+				"ms, " + toString(result.bots_per_ms) + " bots/ms, jitter " + toString(result.jitter) + " rad/tick, min separation " + toString(result.min_separation));
+		}
+		return results;
+	}
+}
+
+#endif
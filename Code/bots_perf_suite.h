@@ -0,0 +1,78 @@
+#pragma once
+
+#ifdef PRIVATE_BUILD
+
+struct Agent;
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Scenario driven performance regression suite.
+          Each scenario configures a set of bots (idle, chasing, knocked back, time stopped, flying),
+          runs them through update_bots_pre / update_bots / update_bots_post for a fixed number of ticks
+          and records p50/p99 tick times per phase. Results are compared against a baseline file:
+
+            <scenario> <phase> <p50 ms> <p99 ms>
+
+          A phase fails when either percentile is slower than the baseline by more than the tolerance.
+
+    ====================================================================================
+*/
+
+    enum BotPerfPhase {
+        BotPerfPhase_Pre,
+        BotPerfPhase_Update,
+        BotPerfPhase_Post,
+        BotPerfPhase_COUNT,
+    };
+
+    struct BotPerfScenario {
+        const char *name = "";
+        size_t bot_count = 0;
+        int ticks = 300;
+        bool flying = false;    // Only uses flying bots.
+        void (*setup)(const std::vector<Agent *> &bots) = nullptr;
+        void (*tick)(const std::vector<Agent *> &bots, int tick) = nullptr;
+    };
+
+    struct BotPerfResult {
+        std::string scenario;
+        double p50[BotPerfPhase_COUNT] = {};   // Milliseconds.
+        double p99[BotPerfPhase_COUNT] = {};
+        bool skipped = false;                   // Not enough (flying) bots in the session.
+    };
+
+    const double BOT_PERF_DEFAULT_TOLERANCE = 0.15;
+
+    const std::vector<BotPerfScenario> &get_bot_perf_scenarios();
+
+    // Runs every scenario on bots taken from the given pool, bots are restored after each scenario.
+    std::vector<BotPerfResult> run_bot_perf_scenarios(const std::vector<Agent *> &bot_pool);
+
+    bool write_bot_perf_baseline(const std::string &path, const std::vector<BotPerfResult> &results);
+
+    // Returns false if any phase regressed beyond tolerance, a baseline scenario was skipped or missing this run,
+    // or the baseline could not be read.
+    bool compare_bot_perf_baseline(const std::string &path, const std::vector<BotPerfResult> &results, double tolerance = BOT_PERF_DEFAULT_TOLERANCE);
+
+    // Runs the suite and compares it against the baseline, or writes the baseline if update_baseline is set.
+    bool run_bot_perf_suite(const std::vector<Agent *> &bot_pool, const std::string &baseline_path, bool update_baseline = false, double tolerance = BOT_PERF_DEFAULT_TOLERANCE);
+
+    struct BotAvoidanceBenchmarkResult {
+        AvoidanceMode mode = AvoidanceMode_Pairwise;
+        double p50 = 0.0;                       // Milliseconds spent in update_avoidance_velocity per tick.
+        double p99 = 0.0;
+        double bots_per_ms = 0.0;               // Throughput at p50.
+        double jitter = 0.0;                    // Mean change of heading per tick of moving bots, in radians.
+        double min_separation = 0.0;            // Closest any two bots got, relative to their combined radius.
+        bool skipped = false;
+    };
+
+    // Sends bot_count ground bots through each other (every bot walks to its mirrored position across the group)
+    // once per AvoidanceMode and reports the cost and smoothness of the avoidance.
+    std::vector<BotAvoidanceBenchmarkResult> run_avoidance_mode_benchmark(const std::vector<Agent *> &bot_pool, size_t bot_count = 500, int ticks = 300);
+}
+
+#endif
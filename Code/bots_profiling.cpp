@@ -0,0 +1,202 @@
+#include "bots.h"
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace bots {
+
+	bool profile_bot_states = false;
+
+	typedef std::pair<unsigned int, unsigned int> StateProfileKey; // { BotType, state }
+
+	// Each thread that updates bots writes into its own block, so recording never takes a lock.
+	struct _StateProfilerThreadData {
+		std::unordered_map<unsigned long long, StateProfile> profiles;
+		std::array<StateTransitionRecord, STATE_TRANSITION_HISTORY_SIZE> history = {};
+		size_t history_head = 0;
+		size_t history_count = 0;
+	};
+	struct _StateProfilerRegistry {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<_StateProfilerThreadData>> threads;
+	};
+
+	_StateProfilerRegistry &_get_profiler_registry() {
+		static _StateProfilerRegistry registry;
+		return registry;
+	}
+	_StateProfilerThreadData &_get_thread_profiler_data() {
+		thread_local _StateProfilerThreadData *data = nullptr;
+
+		if (!data) {
+			_StateProfilerRegistry &registry = _get_profiler_registry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			data = registry.threads.emplace_back(std::make_unique<_StateProfilerThreadData>()).get();
+		}
+		return *data;
+	}
+	StateProfile &_get_state_profile(BotType type, unsigned int state) {
+		unsigned long long key = ((unsigned long long)type << 32) | state;
+		return _get_thread_profiler_data().profiles[key];
+	}
+
+	double get_profiler_time() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	void profile_state_update(BotType type, unsigned int state, double time) {
+		StateProfile &profile = _get_state_profile(type, state);
+		profile.updates++;
+		profile.update_time += time;
+	}
+	void profile_state_enter(BotType type, unsigned int state, double time) {
+		StateProfile &profile = _get_state_profile(type, state);
+		profile.enters++;
+		profile.enter_time += time;
+	}
+	void profile_state_exit(BotType type, unsigned int state, double time, double time_in_state) {
+		StateProfile &profile = _get_state_profile(type, state);
+		profile.exits++;
+		profile.exit_time += time;
+		profile.total_time_in_state += time_in_state;
+	}
+	void profile_state_transition(const Agent &agent, unsigned int from_state, unsigned int to_state, double time_in_state) {
+
+		_StateProfilerThreadData &data = _get_thread_profiler_data();
+
+		StateTransitionRecord &record = data.history[data.history_head];
+		record.timestamp = timing::elapsed_time_seconds;
+		record.agent_id = agent.player_id;
+		record.bot_type = agent.bot_state.type;
+		record.from_state = from_state;
+		record.to_state = to_state;
+		record.time_in_state = time_in_state;
+
+		data.history_head = (data.history_head + 1) % STATE_TRANSITION_HISTORY_SIZE;
+		data.history_count = MIN(data.history_count + 1, STATE_TRANSITION_HISTORY_SIZE);
+	}
+
+	void get_state_profile_snapshot(OUT std::map<StateProfileKey, StateProfile> &profiles, OUT std::vector<StateTransitionRecord> &history) {
+
+		profiles.clear();
+		history.clear();
+
+		_StateProfilerRegistry &registry = _get_profiler_registry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		for (const std::unique_ptr<_StateProfilerThreadData> &data : registry.threads) {
+			for (const auto &[key, profile] : data->profiles) {
+				StateProfile &merged = profiles[{ (unsigned int)(key >> 32), (unsigned int)(key & 0xFFFFFFFF) }];
+				merged.updates += profile.updates;
+				merged.enters += profile.enters;
+				merged.exits += profile.exits;
+				merged.update_time += profile.update_time;
+				merged.enter_time += profile.enter_time;
+				merged.exit_time += profile.exit_time;
+				merged.total_time_in_state += profile.total_time_in_state;
+			}
+
+			// Oldest first within each thread.
+			size_t start = (data->history_head + STATE_TRANSITION_HISTORY_SIZE - data->history_count) % STATE_TRANSITION_HISTORY_SIZE;
+			for (size_t i = 0; i < data->history_count; i++) {
+				history.push_back(data->history[(start + i) % STATE_TRANSITION_HISTORY_SIZE]);
+			}
+		}
+
+		std::sort(history.begin(), history.end(), [](const StateTransitionRecord &a, const StateTransitionRecord &b) {
+			return a.timestamp < b.timestamp;
+		});
+	}
+	void reset_state_profiles() {
+
+		_StateProfilerRegistry &registry = _get_profiler_registry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		for (std::unique_ptr<_StateProfilerThreadData> &data : registry.threads) {
+			data->profiles.clear();
+			data->history_head = 0;
+			data->history_count = 0;
+		}
+	}
+
+	const char *_get_profiled_state_name(unsigned int type, unsigned int state) {
+		const State *state_def = get_state_by_id(static_cast<BotType>(type), state);
+		return state_def ? state_def->name : "none";
+	}
+	const char *_get_profiled_type_name(unsigned int type) {
+		const char *name = type < BotType_COUNT ? enum_to_case_string(static_cast<BotType>(type)) : nullptr;
+		return name ? name : "unknown";
+	}
+
+	std::string export_state_profile_csv() {
+
+		std::map<StateProfileKey, StateProfile> profiles;
+		std::vector<StateTransitionRecord> history;
+		get_state_profile_snapshot(profiles, history);
+
+		std::string csv = "bot_type,state,updates,update_ms,avg_update_us,enters,enter_ms,exits,exit_ms,avg_time_in_state\n";
+		for (const auto &[key, profile] : profiles) {
+			csv += std::string(_get_profiled_type_name(key.first)) + ",";
+			csv += std::string(_get_profiled_state_name(key.first, key.second)) + ",";
+			csv += toString(profile.updates) + ",";
+			csv += toString(profile.update_time * 1000.0) + ",";
+			csv += toString(profile.updates ? profile.update_time / profile.updates * 1000000.0 : 0.0) + ",";
+			csv += toString(profile.enters) + ",";
+			csv += toString(profile.enter_time * 1000.0) + ",";
+			csv += toString(profile.exits) + ",";
+			csv += toString(profile.exit_time * 1000.0) + ",";
+			csv += toString(profile.exits ? profile.total_time_in_state / profile.exits : 0.0) + "\n";
+		}
+
+		return csv;
+	}
+	std::string export_state_profile_json() {
+
+		std::map<StateProfileKey, StateProfile> profiles;
+		std::vector<StateTransitionRecord> history;
+		get_state_profile_snapshot(profiles, history);
+
+		std::string json = "{\n\t\"states\": [";
+		bool first = true;
+		for (const auto &[key, profile] : profiles) {
+			json += first ? "\n" : ",\n";
+			json += "\t\t{ \"bot_type\": \"" + std::string(_get_profiled_type_name(key.first)) + "\"";
+			json += ", \"state\": \"" + std::string(_get_profiled_state_name(key.first, key.second)) + "\"";
+			json += ", \"updates\": " + toString(profile.updates);
+			json += ", \"update_ms\": " + toString(profile.update_time * 1000.0);
+			json += ", \"enters\": " + toString(profile.enters);
+			json += ", \"enter_ms\": " + toString(profile.enter_time * 1000.0);
+			json += ", \"exits\": " + toString(profile.exits);
+			json += ", \"exit_ms\": " + toString(profile.exit_time * 1000.0);
+			json += ", \"avg_time_in_state\": " + toString(profile.exits ? profile.total_time_in_state / profile.exits : 0.0) + " }";
+			first = false;
+		}
+
+		json += "\n\t],\n\t\"transitions\": [";
+		first = true;
+		for (const StateTransitionRecord &record : history) {
+			json += first ? "\n" : ",\n";
+			json += "\t\t{ \"time\": " + toString(record.timestamp);
+			json += ", \"agent_id\": " + toString(record.agent_id);
+			json += ", \"bot_type\": \"" + std::string(_get_profiled_type_name(record.bot_type)) + "\"";
+			json += ", \"from\": \"" + std::string(_get_profiled_state_name(record.bot_type, record.from_state)) + "\"";
+			json += ", \"to\": \"" + std::string(_get_profiled_state_name(record.bot_type, record.to_state)) + "\"";
+			json += ", \"time_in_state\": " + toString(record.time_in_state) + " }";
+			first = false;
+		}
+		json += "\n\t]\n}\n";
+
+		return json;
+	}
+	bool write_state_profile(const std::string &path, bool json) {
+
+		std::ofstream file(path, std::ios::trunc);
+		if (!file) {
+			LOG("Error, could not write bot state profile " + path);
+			return false;
+		}
+
+		file << (json ? export_state_profile_json() : export_state_profile_csv());
+		return file.good();
+	}
+}
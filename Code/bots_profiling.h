@@ -0,0 +1,48 @@
+#pragma once
+#include <map>
+
+struct Agent;
+
+namespace bots {
+
+    enum BotType : unsigned int;
+
+    // Accumulated cost of a single state of a BotType.
+    struct StateProfile {
+        unsigned long long updates = 0;
+        unsigned long long enters = 0;
+        unsigned long long exits = 0;
+        double update_time = 0.0;           // Seconds spent in State::update.
+        double enter_time = 0.0;            // Seconds spent in State::enter.
+        double exit_time = 0.0;             // Seconds spent in State::exit.
+        double total_time_in_state = 0.0;   // Summed time_in_state of every exit, divide by exits for the average.
+    };
+
+    struct StateTransitionRecord {
+        double timestamp = 0.0;
+        unsigned int agent_id = 0;
+        unsigned int bot_type = 0;
+        unsigned int from_state = UINT_MAX;
+        unsigned int to_state = UINT_MAX;
+        double time_in_state = 0.0;         // How long we stayed in from_state.
+    };
+
+    const size_t STATE_TRANSITION_HISTORY_SIZE = 256; // Per thread ring buffer of the latest transitions.
+
+    // Toggles the state profiler on/off, off by default so the timers cost nothing until needed.
+    extern bool profile_bot_states;
+
+    double get_profiler_time();
+    void profile_state_update(BotType type, unsigned int state, double time);
+    void profile_state_enter(BotType type, unsigned int state, double time);
+    void profile_state_exit(BotType type, unsigned int state, double time, double time_in_state);
+    void profile_state_transition(const Agent &agent, unsigned int from_state, unsigned int to_state, double time_in_state);
+
+    // Merges the counters of every thread. Meant to be called in between ticks.
+    void get_state_profile_snapshot(OUT std::map<std::pair<unsigned int, unsigned int>, StateProfile> &profiles, OUT std::vector<StateTransitionRecord> &history);
+    void reset_state_profiles();
+
+    std::string export_state_profile_csv();
+    std::string export_state_profile_json();
+    bool write_state_profile(const std::string &path, bool json = false);
+}
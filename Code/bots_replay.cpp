@@ -0,0 +1,492 @@
+#include "bots.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+extern Randomizer randomizer;
+
+namespace bots {
+
+	BotReplayMode bot_replay_mode = BotReplayMode_Off;
+
+	BotReplayStream &get_bot_replay_stream() {
+		static BotReplayStream stream;
+		return stream;
+	}
+
+	template <typename T>
+	void _write_pod(BotReplayStream &stream, const T &value) {
+		const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+		stream.data.insert(stream.data.end(), bytes, bytes + sizeof(T));
+	}
+	template <typename T>
+	bool _read_pod(BotReplayStream &stream, OUT T &value) {
+		if (stream.read_offset + sizeof(T) > stream.data.size()) { return false; }
+
+		memcpy(&value, stream.data.data() + stream.read_offset, sizeof(T));
+		stream.read_offset += sizeof(T);
+		return true;
+	}
+	void _write_v3(BotReplayStream &stream, const V3 &value) {
+		double xyz[3] = { value.x, value.y, value.z };
+		_write_pod(stream, xyz);
+	}
+	V3 _to_v3(const double (&xyz)[3]) {
+		return V3(xyz[0], xyz[1], xyz[2]);
+	}
+
+	bool _is_recording_pipeline(const BotReplayStream &stream) {
+		return bot_replay_mode == BotReplayMode_Record && stream.in_bot_update;
+	}
+	bool _is_replaying_pipeline(const BotReplayStream &stream) {
+		return bot_replay_mode == BotReplayMode_Replay && stream.in_bot_update && !stream.desynced;
+	}
+	// Consumes the next record if it is of the expected type, otherwise marks the replay as desynced.
+	bool _read_inline_record(BotReplayStream &stream, BotReplayRecordType type) {
+
+		if (stream.read_offset < stream.data.size() && stream.data[stream.read_offset] == type) {
+			stream.read_offset++;
+			return true;
+		}
+
+		LOG("[Bots] Replay desynced at offset " + toString(stream.read_offset) + ", continuing with live inputs");
+		stream.desynced = true;
+		return false;
+	}
+
+	void start_bot_replay_recording(const std::string &path, const std::vector<Agent *> &active_bots) {
+
+		BotReplayStream &stream = get_bot_replay_stream();
+		stream = BotReplayStream();
+		stream.path = path;
+
+		BotReplayHeader header;
+		for (Agent *bot : active_bots) {
+			if (bot) { header.bot_count++; }
+		}
+		_write_pod(stream, header);
+
+		for (Agent *bot : active_bots) {
+			if (!bot) { continue; }
+
+			BotReplayBotSnapshot snapshot;
+			snapshot.agent_id = bot->player_id;
+			snapshot.bot_type = bot->bot_state.type;
+			snapshot.position[0] = bot->battle_state.position.x;
+			snapshot.position[1] = bot->battle_state.position.y;
+			snapshot.position[2] = bot->battle_state.position.z;
+			snapshot.rotation_yaw = bot->battle_state.rotation_yaw;
+			snapshot.max_speed = bot->bot_state.movement.max_speed;
+			_write_pod(stream, snapshot);
+		}
+
+		bot_replay_mode = BotReplayMode_Record;
+	}
+	bool stop_bot_replay_recording() {
+
+		if (bot_replay_mode != BotReplayMode_Record) { return false; }
+		bot_replay_mode = BotReplayMode_Off;
+
+		BotReplayStream &stream = get_bot_replay_stream();
+		std::ofstream file(stream.path, std::ios::binary);
+		if (!file) {
+			LOG("[Bots] Failed to write bot replay " + stream.path);
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char *>(stream.data.data()), stream.data.size());
+		PRINT("[Bots] Wrote bot replay " + stream.path + " (" + toString(stream.data.size()) + " bytes)");
+
+		stream.data.clear();
+		stream.data.shrink_to_fit();
+		return true;
+	}
+
+	void record_bot_replay_tick_pre(const std::vector<Agent *> &active_bots, double dt) {
+
+		if (bot_replay_mode != BotReplayMode_Record) { return; }
+
+		BotReplayStream &stream = get_bot_replay_stream();
+		stream.in_bot_update = true;
+
+		const std::vector<Agent *> &players = gamestate::get_ai_manager(netserver::state).alive_active_players;
+
+		BotReplayTick tick;
+		tick.dt = dt;
+		tick.elapsed_time = timing::elapsed_time_seconds;
+		tick.logic_elapsed_time = timing::logic_elapsed_time_seconds;
+		tick.active_bot_count = (unsigned int)active_bots.size();
+		tick.player_count = (unsigned int)players.size();
+
+		stream.data.push_back(BotReplayRecord_TickPre);
+		_write_pod(stream, tick);
+
+		// Keep the order, the pipeline iterates bots in this order.
+		for (Agent *bot : active_bots) {
+			_write_pod(stream, bot ? bot->player_id : UINT_MAX);
+		}
+		for (Agent *player : players) {
+			BotReplayPlayer record;
+			if (player) {
+				record.agent_id = player->player_id;
+				record.position[0] = player->battle_state.position.x;
+				record.position[1] = player->battle_state.position.y;
+				record.position[2] = player->battle_state.position.z;
+			}
+			_write_pod(stream, record);
+		}
+	}
+	void record_bot_replay_tick_update(unsigned int turn) {
+
+		if (bot_replay_mode != BotReplayMode_Record) { return; }
+
+		BotReplayStream &stream = get_bot_replay_stream();
+		stream.data.push_back(BotReplayRecord_TickUpdate);
+		_write_pod(stream, turn);
+	}
+	void record_bot_replay_tick_post() {
+
+		if (bot_replay_mode != BotReplayMode_Record) { return; }
+
+		BotReplayStream &stream = get_bot_replay_stream();
+		stream.data.push_back(BotReplayRecord_TickPost);
+		stream.in_bot_update = false;
+	}
+	void record_bot_replay_effect(const Agent &bot, BotReplayEffectKind kind, double duration, double scalar, const V3 &velocity, unsigned int held_by_agent_id) {
+
+		BotReplayStream &stream = get_bot_replay_stream();
+		if (bot_replay_mode != BotReplayMode_Record || stream.in_bot_update) { return; }
+
+		BotReplayEffect effect;
+		effect.agent_id = bot.player_id;
+		effect.kind = kind;
+		effect.held_by_agent_id = held_by_agent_id;
+		effect.duration = duration;
+		effect.scalar = scalar;
+		effect.velocity[0] = velocity.x;
+		effect.velocity[1] = velocity.y;
+		effect.velocity[2] = velocity.z;
+
+		stream.data.push_back(BotReplayRecord_Effect);
+		_write_pod(stream, effect);
+	}
+
+	template <typename T>
+	T _bot_rand(BotReplayRecordType type, T max) {
+
+		BotReplayStream &stream = get_bot_replay_stream();
+
+		T value = 0;
+		if (_is_replaying_pipeline(stream) && _read_inline_record(stream, type) && _read_pod(stream, value)) {
+			return value;
+		}
+
+		value = randomizer.rand(max);
+		if (_is_recording_pipeline(stream)) {
+			stream.data.push_back(type);
+			_write_pod(stream, value);
+		}
+		return value;
+	}
+	int bot_rand(int max) {
+		return _bot_rand(BotReplayRecord_Rand, max);
+	}
+	double bot_rand(double max) {
+		return _bot_rand(BotReplayRecord_RandDouble, max);
+	}
+	bool _trace(BotReplayStream &stream, bool hit, const V3 &position) {
+		if (_is_recording_pipeline(stream)) {
+			stream.data.push_back(BotReplayRecord_Trace);
+			_write_pod(stream, (unsigned char)hit);
+			_write_v3(stream, position);
+		}
+		return hit;
+	}
+	bool _read_trace(BotReplayStream &stream, OUT bool &hit, OUT V3 &position) {
+
+		unsigned char recorded_hit = 0;
+		double xyz[3] = {};
+		if (!_read_inline_record(stream, BotReplayRecord_Trace) || !_read_pod(stream, recorded_hit) || !_read_pod(stream, xyz)) {
+			return false;
+		}
+
+		hit = recorded_hit;
+		position = _to_v3(xyz);
+		return true;
+	}
+	bool bot_trace_line_of_sight(const V3 &from, const V3 &to) {
+
+		BotReplayStream &stream = get_bot_replay_stream();
+
+		bool visible = false;
+		V3 unused;
+		if (_is_replaying_pipeline(stream) && _read_trace(stream, visible, unused)) {
+			return visible;
+		}
+
+		// Plane padding might solve issues where we retrieve LOS just around a corner(?)
+		// Try to adjust this if bots need to get around corners more before retrieving LOS.
+		double plane_padding = 0.0;
+
+		RayTrace trace;
+		levels::trace(
+			*game::level, trace,
+			from, to,
+			V3::ZERO, V3::ZERO,
+			true, true, true, plane_padding,
+			true, 812731223, false
+		);
+
+		return _trace(stream, trace.coverage >= 1.0, V3::ZERO);
+	}
+	bool bot_trace_ground(const V3 &position, OUT V3 &ground_position) {
+
+		BotReplayStream &stream = get_bot_replay_stream();
+
+		bool hit = false;
+		if (_is_replaying_pipeline(stream) && _read_trace(stream, hit, ground_position)) {
+			return hit;
+		}
+
+		hit = levels::trace_ground(*game::level, position, ground_position);
+		return _trace(stream, hit, ground_position);
+	}
+
+	void _apply_replayed_effect(const BotReplayEffect &effect) {
+
+		Agent *bot = gamestate::get_agent_by_id(netserver::state, effect.agent_id);
+		if (!bot) { return; }
+
+		switch (effect.kind) {
+			case BotReplayEffect_Immobilize: apply_immobilize(*bot, effect.duration); break;
+			case BotReplayEffect_Speed: apply_speed_effect(*bot, effect.duration, effect.scalar); break;
+			case BotReplayEffect_Slow: apply_slow_effect(*bot, effect.duration, effect.scalar); break;
+			case BotReplayEffect_Stagger: apply_stagger_effect(*bot, effect.duration, effect.scalar); break;
+			case BotReplayEffect_Knockback: apply_knockback(*bot, _to_v3(effect.velocity)); break;
+			case BotReplayEffect_Timestop: apply_timestop(*bot, effect.duration); break;
+			case BotReplayEffect_HeldByAgent: apply_held_by_agent_effect(*bot, effect.held_by_agent_id); break;
+		}
+	}
+	bool _load_bot_replay(BotReplayStream &stream, const std::string &path) {
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			LOG("[Bots] Failed to open bot replay " + path);
+			return false;
+		}
+
+		stream = BotReplayStream();
+		stream.path = path;
+		stream.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		BotReplayHeader header;
+		if (!_read_pod(stream, header) || header.magic != BOT_REPLAY_MAGIC || header.version != BOT_REPLAY_VERSION) {
+			LOG("[Bots] " + path + " is not a bot replay of version " + toString(BOT_REPLAY_VERSION));
+			return false;
+		}
+
+		// Put the bots that exist in this session back where they were when recording started.
+		for (unsigned int i = 0; i < header.bot_count; i++) {
+			BotReplayBotSnapshot snapshot;
+			if (!_read_pod(stream, snapshot)) { return false; }
+
+			Agent *bot = gamestate::get_agent_by_id(netserver::state, snapshot.agent_id);
+			if (!bot || bot->bot_state.type != snapshot.bot_type) { continue; }
+
+			bot->battle_state.position = _to_v3(snapshot.position);
+			bot->battle_state.rotation_yaw = snapshot.rotation_yaw;
+			bot->bot_state.movement.max_speed = snapshot.max_speed;
+		}
+		return true;
+	}
+	bool replay_bot_recording(const std::string &path, const std::string &position_trace_path) {
+
+		BotReplayStream &stream = get_bot_replay_stream();
+		if (bot_replay_mode == BotReplayMode_Record || !_load_bot_replay(stream, path)) { return false; }
+
+		std::ofstream position_trace;
+		if (!position_trace_path.empty()) {
+			position_trace.open(position_trace_path);
+			if (!position_trace) {
+				LOG("[Bots] Failed to write position trace " + position_trace_path);
+				return false;
+			}
+			position_trace.precision(17);
+			position_trace << "# scalar_bytes " << sizeof(BotScalar) << "\n";
+		}
+
+		bot_replay_mode = BotReplayMode_Replay;
+
+		// The recording drives the clock and the player positions, put them back once it is done.
+		const double start_time = timing::elapsed_time_seconds;
+		const double start_logic_time = timing::logic_elapsed_time_seconds;
+		std::unordered_map<unsigned int, V3> player_positions;
+
+		std::vector<Agent *> active_bots;
+		std::vector<double> tick_times;
+		BotReplayTick tick;
+		auto tick_start = std::chrono::high_resolution_clock::now();
+		bool valid = true;
+
+		while (valid && stream.read_offset < stream.data.size()) {
+
+			BotReplayRecordType type = static_cast<BotReplayRecordType>(stream.data[stream.read_offset++]);
+			switch (type) {
+
+				case BotReplayRecord_TickPre: {
+					if (!_read_pod(stream, tick)) { valid = false; break; }
+
+					timing::elapsed_time_seconds = tick.elapsed_time;
+					timing::logic_elapsed_time_seconds = tick.logic_elapsed_time;
+
+					active_bots.clear();
+					for (unsigned int i = 0; i < tick.active_bot_count; i++) {
+						unsigned int agent_id = UINT_MAX;
+						if (!_read_pod(stream, agent_id)) { valid = false; break; }
+
+						if (Agent *bot = gamestate::get_agent_by_id(netserver::state, agent_id)) {
+							active_bots.push_back(bot);
+						}
+					}
+					for (unsigned int i = 0; valid && i < tick.player_count; i++) {
+						BotReplayPlayer player;
+						if (!_read_pod(stream, player)) { valid = false; break; }
+
+						if (Agent *agent = gamestate::get_agent_by_id(netserver::state, player.agent_id)) {
+							player_positions.try_emplace(player.agent_id, agent->battle_state.position);
+							agent->battle_state.position = _to_v3(player.position);
+						}
+					}
+					if (!valid) { break; }
+
+					tick_start = std::chrono::high_resolution_clock::now();
+					stream.in_bot_update = true;
+					update_bots_pre(active_bots, tick.dt);
+					break;
+				}
+				case BotReplayRecord_TickUpdate: {
+					unsigned int turn = 0;
+					if (!_read_pod(stream, turn)) { valid = false; break; }
+
+					update_bots(active_bots, tick.dt, turn);
+					break;
+				}
+				case BotReplayRecord_TickPost: {
+					update_bots_post(active_bots, tick.dt);
+					stream.in_bot_update = false;
+
+					std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - tick_start;
+					tick_times.push_back(elapsed.count());
+
+					if (position_trace.is_open()) {
+						for (Agent *bot : active_bots) {
+							const V3 &position = bot->battle_state.position;
+							position_trace << tick_times.size() << " " << bot->player_id << " " << position.x << " " << position.y << " " << position.z << "\n";
+						}
+					}
+					break;
+				}
+				case BotReplayRecord_Effect: {
+					BotReplayEffect effect;
+					if (!_read_pod(stream, effect)) { valid = false; break; }
+
+					_apply_replayed_effect(effect);
+					break;
+				}
+				default:
+					// Rand/Trace records are consumed by the pipeline, ending up here means the pipeline took another path.
+					LOG("[Bots] Unexpected record " + toString((int)type) + " in bot replay at offset " + toString(stream.read_offset - 1));
+					valid = false;
+					break;
+			}
+		}
+
+		stream.in_bot_update = false;
+		bot_replay_mode = BotReplayMode_Off;
+
+		timing::elapsed_time_seconds = start_time;
+		timing::logic_elapsed_time_seconds = start_logic_time;
+		for (const auto &[agent_id, position] : player_positions) {
+			if (Agent *agent = gamestate::get_agent_by_id(netserver::state, agent_id)) {
+				agent->battle_state.position = position;
+			}
+		}
+
+		if (tick_times.empty()) { return false; }
+
+		double total = 0.0;
+		double worst = 0.0;
+		for (double time : tick_times) {
+			total += time;
+			worst = MAX(worst, time);
+		}
+
+		PRINT("[Bots] Replayed " + toString(tick_times.size()) + " ticks of " + path + " in " + toString(total * 1000.0) + "ms, avg " +
+			toString(total / tick_times.size() * 1000.0) + "ms, worst " + toString(worst * 1000.0) + "ms" + (stream.desynced ? " (desynced)" : ""));
+
+		return valid && !stream.desynced;
+	}
+
+	bool _read_position_trace(const std::string &path, OUT std::unordered_map<unsigned long long, V3> &positions, OUT size_t &scalar_bytes) {
+
+		std::ifstream file(path);
+		if (!file) {
+			LOG("[Bots] Failed to read position trace " + path);
+			return false;
+		}
+
+		std::string line;
+		while (std::getline(file, line)) {
+			std::istringstream stream(line);
+
+			if (line.rfind("# scalar_bytes", 0) == 0) {
+				std::string unused;
+				stream >> unused >> unused >> scalar_bytes;
+				continue;
+			}
+
+			unsigned long long tick = 0;
+			unsigned int agent_id = 0;
+			V3 position;
+			if (!(stream >> tick >> agent_id >> position.x >> position.y >> position.z)) { continue; }
+
+			positions[(tick << 32) | agent_id] = position;
+		}
+		return true;
+	}
+	bool compare_bot_position_traces(const std::string &path_a, const std::string &path_b, OUT double &max_drift) {
+
+		max_drift = 0.0;
+
+		std::unordered_map<unsigned long long, V3> positions_a, positions_b;
+		size_t scalar_bytes_a = 0, scalar_bytes_b = 0;
+		if (!_read_position_trace(path_a, positions_a, scalar_bytes_a) || !_read_position_trace(path_b, positions_b, scalar_bytes_b)) { return false; }
+
+		unsigned long long worst_key = 0;
+		size_t missing = 0;
+		double total_drift = 0.0;
+
+		for (const auto &entry : positions_a) {
+			auto other = positions_b.find(entry.first);
+			if (other == positions_b.end()) {
+				missing++;
+				continue;
+			}
+
+			const double drift = entry.second.distance(other->second);
+			total_drift += drift;
+			if (drift > max_drift) {
+				max_drift = drift;
+				worst_key = entry.first;
+			}
+		}
+
+		const size_t compared = positions_a.size() - missing;
+		PRINT("[Bots] Position drift " + toString(scalar_bytes_a * 8) + " vs " + toString(scalar_bytes_b * 8) + " bit: max " + toString(max_drift) +
+			" (tick " + toString(worst_key >> 32) + ", agent " + toString((unsigned int)(worst_key & 0xFFFFFFFF)) + "), mean " +
+			toString(compared ? total_drift / compared : 0.0) + ", " + toString(compared) + " samples, " + toString(missing + (positions_b.size() - compared)) + " unmatched");
+
+		// Unmatched samples mean the runs took different paths (e.g. a bot died in one of them), the drift alone doesn't show that.
+		return missing == 0 && positions_b.size() == compared;
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+struct Agent;
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Record / replay of the bot simulation inputs.
+          While recording, every tick appends its inputs to a binary stream:
+
+            [BotReplayHeader]
+            [BotReplayBotSnapshot x bot_count]                  Bots active when recording started.
+            records, each prefixed by a BotReplayRecordType byte:
+                TickPre     BotReplayTick, active bot ids, BotReplayPlayer x player_count
+                TickUpdate  turn
+                TickPost
+                Effect      BotReplayEffect, applied from outside the bot pipeline
+                Rand        int, result of bot_rand(int)
+                RandDouble  double, result of bot_rand(double)
+                Trace       u8 hit (+ V3 position for ground traces)
+
+          Replaying feeds the same inputs back through update_bots_pre/update_bots/update_bots_post
+          as fast as possible, with RNG draws and traces served from the stream.
+
+    ====================================================================================
+*/
+
+    const unsigned int BOT_REPLAY_MAGIC = 0x4C505242;   // "BRPL"
+    const unsigned int BOT_REPLAY_VERSION = 2;
+
+    enum BotReplayMode {
+        BotReplayMode_Off,
+        BotReplayMode_Record,
+        BotReplayMode_Replay,
+    };
+
+    enum BotReplayRecordType : unsigned char {
+        BotReplayRecord_TickPre,
+        BotReplayRecord_TickUpdate,
+        BotReplayRecord_TickPost,
+        BotReplayRecord_Effect,
+        BotReplayRecord_Rand,
+        BotReplayRecord_Trace,
+        BotReplayRecord_RandDouble,
+    };
+
+    enum BotReplayEffectKind : unsigned int {
+        BotReplayEffect_Immobilize,
+        BotReplayEffect_Speed,
+        BotReplayEffect_Slow,
+        BotReplayEffect_Stagger,
+        BotReplayEffect_Knockback,
+        BotReplayEffect_Timestop,
+        BotReplayEffect_HeldByAgent,
+    };
+
+    struct BotReplayHeader {
+        unsigned int magic = BOT_REPLAY_MAGIC;
+        unsigned int version = BOT_REPLAY_VERSION;
+        unsigned int bot_count = 0;
+    };
+    struct BotReplayBotSnapshot {
+        unsigned int agent_id = 0;
+        unsigned int bot_type = 0;
+        double position[3] = {};
+        double rotation_yaw = 0.0;
+        double max_speed = 0.0;
+    };
+    struct BotReplayTick {
+        double dt = 0.0;
+        double elapsed_time = 0.0;
+        double logic_elapsed_time = 0.0;
+        unsigned int active_bot_count = 0;
+        unsigned int player_count = 0;
+    };
+    struct BotReplayPlayer {
+        unsigned int agent_id = 0;
+        double position[3] = {};
+    };
+    struct BotReplayEffect {
+        unsigned int agent_id = 0;
+        unsigned int kind = 0;
+        unsigned int held_by_agent_id = 0;
+        double duration = 0.0;
+        double scalar = 0.0;
+        double velocity[3] = {};
+    };
+
+    struct BotReplayStream {
+        std::vector<unsigned char> data;
+        size_t read_offset = 0;
+        std::string path;
+        bool in_bot_update = false;     // Effects applied by the pipeline itself are reproduced by replaying it, not recorded.
+        bool desynced = false;          // Replay asked for a different record than the stream holds, live calls are used from then on.
+    };
+
+    extern BotReplayMode bot_replay_mode;
+
+    BotReplayStream &get_bot_replay_stream();
+
+    void start_bot_replay_recording(const std::string &path, const std::vector<Agent *> &active_bots);
+    bool stop_bot_replay_recording();
+
+    // Runs a recording headless, as fast as possible, and prints the tick timings.
+    // With a position_trace_path, every bot's position after each tick is written there as "<tick> <agent id> <x> <y> <z>" lines.
+    bool replay_bot_recording(const std::string &path, const std::string &position_trace_path = "");
+
+    // Compares two position traces of the same recording, e.g. from the double and the BOTS_SCALAR_FLOAT32 build,
+    // and prints the largest distance between the two runs of any bot on any tick.
+    bool compare_bot_position_traces(const std::string &path_a, const std::string &path_b, OUT double &max_drift);
+
+    // Called by the update functions, no-ops unless recording.
+    void record_bot_replay_tick_pre(const std::vector<Agent *> &active_bots, double dt);
+    void record_bot_replay_tick_update(unsigned int turn);
+    void record_bot_replay_tick_post();
+    void record_bot_replay_effect(const Agent &bot, BotReplayEffectKind kind, double duration, double scalar, const V3 &velocity = V3::ZERO, unsigned int held_by_agent_id = 0);
+
+    // Nondeterministic inputs of the pipeline, recorded or served from the stream depending on bot_replay_mode.
+    int bot_rand(int max);
+    double bot_rand(double max);
+    bool bot_trace_line_of_sight(const V3 &from, const V3 &to);
+    bool bot_trace_ground(const V3 &position, OUT V3 &ground_position);
+}
@@ -0,0 +1,281 @@
+#include "bots.h"
+
+namespace bots {
+
+	bool batched_bot_replication = false;
+
+	BotReplicationState &get_bot_replication_state() {
+		static BotReplicationState state;
+		return state;
+	}
+
+	short _quantize_blend_velocity(double value) {
+		return (short)CLAMP(round(value / BOT_REPLICATION_VELOCITY_STEP), (double)SHRT_MIN, (double)SHRT_MAX);
+	}
+	void _mark_dirty(BotReplicationState &state, unsigned int agent_id, BotReplicationEntry &entry) {
+		if (entry.queued) { return; }
+
+		entry.queued = true;
+		state.dirty.push_back(agent_id);
+	}
+
+	void _write_varint(std::vector<unsigned char> &buffer, unsigned int value) {
+		while (value >= 0x80) {
+			buffer.push_back((unsigned char)(value | 0x80));
+			value >>= 7;
+		}
+		buffer.push_back((unsigned char)value);
+	}
+	bool _read_varint(const unsigned char *&data, const unsigned char *end, OUT unsigned int &value) {
+		value = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			if (data >= end) { return false; }
+
+			unsigned char byte = *data++;
+			value |= (unsigned int)(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) { return true; }
+		}
+		return false;
+	}
+	unsigned int _zigzag(int value) {
+		return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+	}
+	int _unzigzag(unsigned int value) {
+		return (int)(value >> 1) ^ -(int)(value & 1);
+	}
+
+	void queue_root_motion_blend_value(const Agent &agent, const V3 &blend_velocity, bool stop_root_motion) {
+
+		BotReplicationState &state = get_bot_replication_state();
+		state.queued_root_motion_events++;
+
+		BotReplicationEntry &entry = state.latest[agent.player_id];
+		BotReplicationValues &values = entry.values;
+
+		values.blend_velocity[0] = _quantize_blend_velocity(blend_velocity.x);
+		values.blend_velocity[1] = _quantize_blend_velocity(blend_velocity.y);
+		values.blend_velocity[2] = _quantize_blend_velocity(blend_velocity.z);
+		values.stop_root_motion = stop_root_motion;
+		values.has_root_motion = true;
+		_mark_dirty(state, agent.player_id, entry);
+	}
+	void queue_bot_target(const Agent &agent, unsigned int target_agent_id) {
+
+		BotReplicationState &state = get_bot_replication_state();
+		state.queued_target_events++;
+
+		BotReplicationEntry &entry = state.latest[agent.player_id];
+		BotReplicationValues &values = entry.values;
+
+		values.target_agent_id = target_agent_id;
+		values.has_target = true;
+		_mark_dirty(state, agent.player_id, entry);
+	}
+	void forget_bot_replication(unsigned int agent_id) {
+
+		BotReplicationState &state = get_bot_replication_state();
+		state.latest.erase(agent_id);
+		state.dirty.erase(std::remove(state.dirty.begin(), state.dirty.end(), agent_id), state.dirty.end());
+
+		for (auto &[client_id, baseline] : state.client_baselines) {
+			baseline.erase(agent_id);
+		}
+	}
+
+	// Appends the fields of current that differ from baseline, and updates baseline to match. Returns false if nothing changed.
+	// A reset entry is always written, baseline is then a fresh one and the deltas are the absolute values.
+	bool _encode_entry(std::vector<unsigned char> &buffer, unsigned int id_delta, const BotReplicationValues &current, BotReplicationValues &baseline, bool reset) {
+
+		unsigned char mask = reset ? BotReplicationField_Reset : BotReplicationField_None;
+
+		if (current.has_root_motion && (!baseline.has_root_motion || current.stop_root_motion != baseline.stop_root_motion)) {
+			mask |= BotReplicationField_RootMotion;
+			if (current.stop_root_motion) { mask |= BotReplicationField_StopRootMotion; }
+		}
+		if (current.has_root_motion) {
+			if (current.blend_velocity[0] != baseline.blend_velocity[0]) { mask |= BotReplicationField_BlendX; }
+			if (current.blend_velocity[1] != baseline.blend_velocity[1]) { mask |= BotReplicationField_BlendY; }
+			if (current.blend_velocity[2] != baseline.blend_velocity[2]) { mask |= BotReplicationField_BlendZ; }
+		}
+		if (current.has_target && (!baseline.has_target || current.target_agent_id != baseline.target_agent_id)) {
+			mask |= BotReplicationField_Target;
+		}
+
+		if (mask == BotReplicationField_None) { return false; }
+
+		_write_varint(buffer, id_delta);
+		buffer.push_back(mask);
+
+		for (int axis = 0; axis < 3; axis++) {
+			if (!(mask & (BotReplicationField_BlendX << axis))) { continue; }
+			_write_varint(buffer, _zigzag(current.blend_velocity[axis] - baseline.blend_velocity[axis]));
+		}
+		if (mask & BotReplicationField_Target) {
+			_write_varint(buffer, current.target_agent_id);
+		}
+
+		baseline = current;
+		return true;
+	}
+	void _send_batch(BotReplicationState &state, Agent &client, unsigned int entry_count) {
+
+		BotReplicationBatchHeader header;
+		header.entry_count = (unsigned short)entry_count;
+		header.tick = state.tick;
+		memcpy(state.buffer.data(), &header, sizeof(header));
+
+		netserver::send_message(client.peer, agents::get_net_channel(client, NET_CHANNEL_TYPE_RELIABLE), state.buffer.data(), state.buffer.size());
+
+		state.stats.batches_sent++;
+		state.stats.bytes_sent += state.buffer.size();
+		state.stats.entries_sent += entry_count;
+	}
+	void _flush_client(BotReplicationState &state, Agent &client, const std::vector<unsigned int> &agent_ids) {
+
+		std::unordered_map<unsigned int, BotReplicationValues> &baseline = state.client_baselines[client.player_id];
+
+		state.buffer.resize(sizeof(BotReplicationBatchHeader));
+		unsigned int entry_count = 0;
+		unsigned int previous_id = 0;
+
+		for (unsigned int agent_id : agent_ids) {
+
+			auto it = state.latest.find(agent_id);
+			if (it == state.latest.end()) { continue; }
+
+			// No baseline means the client hasn't seen this life of the id yet.
+			auto [baseline_it, reset] = baseline.try_emplace(agent_id);
+			if (!_encode_entry(state.buffer, agent_id - previous_id, it->second.values, baseline_it->second, reset)) {
+				state.stats.entries_skipped++;
+				continue;
+			}
+			previous_id = agent_id;
+
+			if (++entry_count == USHRT_MAX) {
+				_send_batch(state, client, entry_count);
+				state.buffer.resize(sizeof(BotReplicationBatchHeader));
+				entry_count = 0;
+				previous_id = 0;
+			}
+		}
+
+		if (entry_count) {
+			_send_batch(state, client, entry_count);
+		}
+	}
+	void flush_bot_replication() {
+
+		BotReplicationState &state = get_bot_replication_state();
+		state.tick++;
+
+		static std::vector<unsigned int> all_ids;
+		static std::vector<unsigned int> live_clients;
+		live_clients.clear();
+
+		// Sorted ids keep the id deltas small.
+		std::sort(state.dirty.begin(), state.dirty.end());
+
+		for (const auto &[id, agent_ptr] : gamestate::get_agents(netserver::state)) {
+			if (!agent_ptr || agent_ptr->is_bot_server) { continue; }
+
+			Agent &client = *agent_ptr;
+			live_clients.push_back(client.player_id);
+
+			state.stats.unbatched_messages += state.queued_root_motion_events + state.queued_target_events;
+			state.stats.unbatched_bytes += state.queued_root_motion_events * sizeof(messages::MsgEntityEvent);
+
+			// Clients we haven't sent anything yet get the full state of every bot.
+			if (state.client_baselines.find(client.player_id) == state.client_baselines.end()) {
+				all_ids.clear();
+				for (const auto &[agent_id, entry] : state.latest) {
+					all_ids.push_back(agent_id);
+				}
+				std::sort(all_ids.begin(), all_ids.end());
+				_flush_client(state, client, all_ids);
+				continue;
+			}
+
+			if (!state.dirty.empty()) {
+				_flush_client(state, client, state.dirty);
+			}
+		}
+
+		// Drop baselines of clients that left.
+		if (state.client_baselines.size() > live_clients.size()) {
+			for (auto it = state.client_baselines.begin(); it != state.client_baselines.end();) {
+				if (std::find(live_clients.begin(), live_clients.end(), it->first) == live_clients.end()) {
+					it = state.client_baselines.erase(it);
+				} else {
+					++it;
+				}
+			}
+		}
+
+		for (unsigned int agent_id : state.dirty) {
+			auto it = state.latest.find(agent_id);
+			if (it != state.latest.end()) { it->second.queued = false; }
+		}
+		state.dirty.clear();
+		state.queued_root_motion_events = 0;
+		state.queued_target_events = 0;
+	}
+
+	bool decode_bot_replication_batch(const unsigned char *data, size_t size, std::unordered_map<unsigned int, BotReplicationValues> &baseline) {
+
+		BotReplicationBatchHeader header;
+		if (size < sizeof(header)) { return false; }
+
+		memcpy(&header, data, sizeof(header));
+		if (header.msg_type != BOT_REPLICATION_MSG_TYPE) { return false; }
+
+		const unsigned char *it = data + sizeof(header);
+		const unsigned char *end = data + size;
+		unsigned int agent_id = 0;
+
+		for (unsigned int i = 0; i < header.entry_count; i++) {
+
+			unsigned int id_delta = 0;
+			if (!_read_varint(it, end, id_delta) || it >= end) { return false; }
+
+			agent_id += id_delta;
+			unsigned char mask = *it++;
+			BotReplicationValues &values = baseline[agent_id];
+
+			if (mask & BotReplicationField_Reset) {
+				values = BotReplicationValues();
+			}
+			if (mask & BotReplicationField_RootMotion) {
+				values.stop_root_motion = mask & BotReplicationField_StopRootMotion;
+				values.has_root_motion = true;
+			}
+			for (int axis = 0; axis < 3; axis++) {
+				if (!(mask & (BotReplicationField_BlendX << axis))) { continue; }
+
+				unsigned int delta = 0;
+				if (!_read_varint(it, end, delta)) { return false; }
+				values.blend_velocity[axis] = (short)(values.blend_velocity[axis] + _unzigzag(delta));
+				values.has_root_motion = true;
+			}
+			if (mask & BotReplicationField_Target) {
+				if (!_read_varint(it, end, values.target_agent_id)) { return false; }
+				values.has_target = true;
+			}
+		}
+
+		return it == end;
+	}
+
+	void reset_bot_replication_stats() {
+		get_bot_replication_state().stats = BotReplicationStats();
+	}
+	void print_bot_replication_stats() {
+
+		const BotReplicationStats &stats = get_bot_replication_state().stats;
+		double saved = stats.unbatched_bytes ? 100.0 * (1.0 - (double)stats.bytes_sent / (double)stats.unbatched_bytes) : 0.0;
+
+		PRINT("[Bots] Replication: " + toString(stats.batches_sent) + " batches, " + toString(stats.bytes_sent) + " bytes, " +
+			toString(stats.entries_sent) + " entries sent, " + toString(stats.entries_skipped) + " unchanged entries skipped");
+		PRINT("[Bots] Unbatched equivalent: " + toString(stats.unbatched_messages) + " messages, " + toString(stats.unbatched_bytes) +
+			" bytes of root motion events (" + toString(saved) + "% saved)");
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <unordered_map>
+
+struct Agent;
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Batched bot replication.
+          Root motion blend values and target changes are queued during the tick and flushed
+          once per client at the end of it as a single packed message:
+
+            [BotReplicationBatchHeader]
+            [entry x entry_count]
+                varint  agent id delta from the previous entry (ids are sorted)
+                u8      BotReplicationField mask of what follows
+                varint  zigzag delta of each quantized blend velocity axis in the mask
+                varint  target agent id, if in the mask
+
+          Fields are delta compressed against what the client last received. Batches go over the
+          reliable channel, so anything sent is treated as acknowledged. The first entry of an id
+          after forget_bot_replication carries BotReplicationField_Reset, so the client drops
+          whatever it still holds for a previous life of that id before applying the deltas.
+
+    ====================================================================================
+*/
+
+    const unsigned short BOT_REPLICATION_MSG_TYPE = 0xB07; // Must match the client side decoder registration.
+    const double BOT_REPLICATION_VELOCITY_STEP = 0.5;      // Blend velocity quantization, in units per second.
+
+    enum BotReplicationField : unsigned char {
+        BotReplicationField_None = 0,
+        BotReplicationField_RootMotion = 1 << 0,    // Root motion state changed, the new state is BotReplicationField_StopRootMotion.
+        BotReplicationField_StopRootMotion = 1 << 1,
+        BotReplicationField_BlendX = 1 << 2,
+        BotReplicationField_BlendY = 1 << 3,
+        BotReplicationField_BlendZ = 1 << 4,
+        BotReplicationField_Target = 1 << 5,
+        BotReplicationField_Reset = 1 << 6,         // Values are absolute, the receiver clears its baseline of this id first.
+    };
+
+    struct BotReplicationBatchHeader {
+        unsigned short msg_type = BOT_REPLICATION_MSG_TYPE;
+        unsigned short entry_count = 0;
+        unsigned int tick = 0;
+    };
+
+    // Last replicated values of a single bot, quantized.
+    struct BotReplicationValues {
+        short blend_velocity[3] = {};
+        unsigned int target_agent_id = UINT_MAX;
+        bool stop_root_motion = false;
+        bool has_root_motion = false;
+        bool has_target = false;
+    };
+
+    struct BotReplicationEntry {
+        BotReplicationValues values;
+        bool queued = false;    // Already in BotReplicationState::dirty this tick.
+    };
+
+    struct BotReplicationStats {
+        unsigned long long batches_sent = 0;
+        unsigned long long bytes_sent = 0;
+        unsigned long long entries_sent = 0;
+        unsigned long long entries_skipped = 0;         // Queued but unchanged for that client.
+        unsigned long long unbatched_messages = 0;      // Messages the per event path would have sent.
+        unsigned long long unbatched_bytes = 0;
+    };
+
+    struct BotReplicationState {
+        std::unordered_map<unsigned int, BotReplicationEntry> latest;                                           // Agent id -> current values.
+        std::vector<unsigned int> dirty;                                                                        // Agent ids queued this tick.
+        std::unordered_map<unsigned int, std::unordered_map<unsigned int, BotReplicationValues>> client_baselines; // Client id -> agent id -> last sent.
+        std::vector<unsigned char> buffer;                                                                      // Reused encode buffer.
+        unsigned int queued_root_motion_events = 0;
+        unsigned int queued_target_events = 0;
+        unsigned int tick = 0;
+        BotReplicationStats stats;
+    };
+
+    // Enables batching, otherwise every event is sent right away as its own message.
+    extern bool batched_bot_replication;
+
+    BotReplicationState &get_bot_replication_state();
+
+    void queue_root_motion_blend_value(const Agent &agent, const V3 &blend_velocity, bool stop_root_motion);
+    void queue_bot_target(const Agent &agent, unsigned int target_agent_id);
+    void forget_bot_replication(unsigned int agent_id);
+
+    // Encodes and sends the queued events, one message per client.
+    void flush_bot_replication();
+
+    // Client side counterpart of the encoder, applies a batch on top of baseline. Returns false on malformed data.
+    bool decode_bot_replication_batch(const unsigned char *data, size_t size, std::unordered_map<unsigned int, BotReplicationValues> &baseline);
+
+    void reset_bot_replication_stats();
+    void print_bot_replication_stats();
+}
@@ -0,0 +1,141 @@
+#include "bots.h"
+
+namespace bots {
+
+	bool cached_root_motion = false;
+
+	RootMotionCache &get_root_motion_cache() {
+		static RootMotionCache cache;
+		return cache;
+	}
+
+	void register_root_motion_curve(unsigned long long clip_hash, const std::vector<V3> &positions, double duration, bool velocity_blended, bool looping) {
+
+		if (positions.size() < 2 || duration <= 0.0) {
+			LOG("[Bots] Ignoring root motion curve without samples or duration");
+			return;
+		}
+
+		RootMotionCurve &curve = get_root_motion_cache().curves[clip_hash];
+		curve.positions = positions;
+		curve.duration = duration;
+		curve.looping = looping;
+		curve.velocity_blended = velocity_blended;
+	}
+	const RootMotionCurve *get_root_motion_curve(unsigned long long clip_hash) {
+
+		if (!clip_hash) { return nullptr; }
+
+		const RootMotionCache &cache = get_root_motion_cache();
+		auto it = cache.curves.find(clip_hash);
+		return it != cache.curves.end() ? &it->second : nullptr;
+	}
+	void set_root_motion_clip(Movement &movement, unsigned long long clip_hash, double start_time) {
+		movement.root_motion_clip = clip_hash;
+		movement.root_motion_clip_time = start_time;
+	}
+	bool _is_root_motion_frozen(const Movement &movement) {
+		return movement.movement_effects[TimeStop].active;
+	}
+	bool can_sample_cached_root_motion(const Agent &agent) {
+
+		if (!cached_root_motion) { return false; }
+
+		const Movement &movement = agent.bot_state.movement;
+		const RootMotionCurve *curve = get_root_motion_curve(movement.root_motion_clip);
+		if (!curve || curve->velocity_blended) { return false; }
+
+		return agent.battle_state.rotation_pitch == 0.0 && !_is_root_motion_frozen(movement);
+	}
+	void advance_root_motion_clip(Movement &movement, double dt) {
+
+		if (_is_root_motion_frozen(movement)) { return; }
+
+		const RootMotionCurve *curve = get_root_motion_curve(movement.root_motion_clip);
+		if (!curve) { return; }
+
+		movement.root_motion_clip_time += dt;
+		if (curve->looping) {
+			movement.root_motion_clip_time = fmod(movement.root_motion_clip_time, curve->duration);
+		}
+	}
+
+	V3 sample_root_motion_curve(const RootMotionCurve &curve, double normalized_time) {
+
+		const double sample = CLAMP(normalized_time, 0.0, 1.0) * (curve.positions.size() - 1);
+		const size_t index = MIN((size_t)sample, curve.positions.size() - 2);
+		const double t = sample - index;
+
+		return curve.positions[index] + (curve.positions[index + 1] - curve.positions[index]) * t;
+	}
+	V3 get_root_motion_curve_delta(const RootMotionCurve &curve, double time, double dt) {
+
+		const double start = time / curve.duration;
+		double end = (time + dt) / curve.duration;
+
+		if (!curve.looping || end <= 1.0) {
+			return sample_root_motion_curve(curve, MIN(end, 1.0)) - sample_root_motion_curve(curve, start);
+		}
+
+		// Wrapped around, the displacement is the rest of this loop plus the start of the next one.
+		end -= floor(end);
+		return (curve.positions.back() - sample_root_motion_curve(curve, start)) + (sample_root_motion_curve(curve, end) - curve.positions[0]);
+	}
+
+	void sample_root_motion_batch(const std::vector<Agent *> &agents, double dt, OUT std::vector<V3> &out_deltas) {
+
+		RootMotionCache &cache = get_root_motion_cache();
+
+		// Pad to a multiple of 4 so the SIMD loop never needs a scalar tail.
+		const size_t count = agents.size();
+		const size_t padded_count = (count + 3) & ~(size_t)3;
+		cache.x.assign(padded_count, 0.0f);
+		cache.y.assign(padded_count, 0.0f);
+		cache.z.assign(padded_count, 0.0f);
+		cache.sin_yaw.assign(padded_count, 0.0f);
+		cache.cos_yaw.assign(padded_count, 0.0f);
+		cache.scale.assign(padded_count, 0.0f);
+
+		for (size_t i = 0; i < count; i++) {
+			Agent &agent = *agents[i];
+			Movement &movement = agent.bot_state.movement;
+			const RootMotionCurve &curve = *get_root_motion_curve(movement.root_motion_clip);
+
+			const V3 local_delta = get_root_motion_curve_delta(curve, movement.root_motion_clip_time, dt);
+			advance_root_motion_clip(movement, dt);
+
+			cache.x[i] = (float)local_delta.x;
+			cache.y[i] = (float)local_delta.y;
+			cache.z[i] = (float)local_delta.z;
+			cache.sin_yaw[i] = (float)sin(agent.battle_state.rotation_yaw);
+			cache.cos_yaw[i] = (float)cos(agent.battle_state.rotation_yaw);
+			cache.scale[i] = (float)agent.agent_scale;
+		}
+
+		// Local to world for 4 bots at a time. can_sample_cached_root_motion() only lets unpitched bots in, so this is the rotation of
+		// algebra::rotate_point_by_yaw plus scale.
+		for (size_t i = 0; i < padded_count; i += 4) {
+			using namespace DirectX;
+
+			XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(&cache.x[i]));
+			XMVECTOR y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(&cache.y[i]));
+			XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(&cache.z[i]));
+			XMVECTOR s = XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(&cache.sin_yaw[i]));
+			XMVECTOR c = XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(&cache.cos_yaw[i]));
+			XMVECTOR scale = XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(&cache.scale[i]));
+
+			XMVECTOR world_x = XMVectorMultiply(XMVectorMultiplyAdd(x, c, XMVectorMultiply(z, s)), scale);
+			XMVECTOR world_z = XMVectorMultiply(XMVectorNegativeMultiplySubtract(x, s, XMVectorMultiply(z, c)), scale);
+			XMVECTOR world_y = XMVectorMultiply(y, scale);
+
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(&cache.x[i]), world_x);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(&cache.y[i]), world_y);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(&cache.z[i]), world_z);
+		}
+
+		out_deltas.resize(count);
+		for (size_t i = 0; i < count; i++) {
+			out_deltas[i] = V3(cache.x[i], cache.y[i], cache.z[i]);
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <unordered_map>
+
+struct Agent;
+
+namespace bots {
+
+    struct Movement;
+
+    // Root displacement of a clip baked at evenly spaced times, sampled instead of asking the animation system every tick.
+    struct RootMotionCurve {
+        std::vector<V3> positions;      // Accumulated local root position per sample, positions[0] is the clip start and positions.back() its end.
+        double duration = 0.0;
+        bool looping = true;
+        bool velocity_blended = false;  // Root motion depends on the requested velocity (blend spaces), which a baked curve can't reproduce.
+    };
+
+    struct RootMotionCache {
+        std::unordered_map<unsigned long long, RootMotionCurve> curves; // Clip hash -> curve.
+
+        // Scratch SoA buffers for the batched local to world transform.
+        std::vector<Agent *> agents;
+        std::vector<float> x, y, z, sin_yaw, cos_yaw, scale;
+    };
+
+    // Enables sampling root motion from the cache for bots that have a cached clip playing.
+    extern bool cached_root_motion;
+
+    RootMotionCache &get_root_motion_cache();
+
+    // Called when clips are loaded. positions are the local root positions sampled evenly over duration, velocity_blended
+    // clips are kept but never sampled from the cache.
+    void register_root_motion_curve(unsigned long long clip_hash, const std::vector<V3> &positions, double duration, bool velocity_blended, bool looping = true);
+    const RootMotionCurve *get_root_motion_curve(unsigned long long clip_hash);
+
+    // Tells the cache which clip a bot started playing, clip_hash 0 falls back to the animation system.
+    void set_root_motion_clip(Movement &movement, unsigned long long clip_hash, double start_time = 0.0);
+
+    // The cache is only used where it matches get_current_anim_root_motion: a clip that isn't velocity blended, no pitch
+    // (the batch only applies yaw and scale), and not frozen by TimeStop.
+    bool can_sample_cached_root_motion(const Agent &agent);
+
+    // Keeps root_motion_clip_time in step with the animation, also while the bot falls back to the animation system.
+    // Frozen while TimeStop holds the animation.
+    void advance_root_motion_clip(Movement &movement, double dt);
+
+    V3 sample_root_motion_curve(const RootMotionCurve &curve, double normalized_time);
+    V3 get_root_motion_curve_delta(const RootMotionCurve &curve, double time, double dt);
+
+    // Advances the clip of every bot in agents and writes their world space root motion delta into out_deltas,
+    // transforming all of them in a single SIMD pass.
+    void sample_root_motion_batch(const std::vector<Agent *> &agents, double dt, OUT std::vector<V3> &out_deltas);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Scalar type of the bot simulation's own working set (SoA batches, solver snapshots, fields).
+          Define BOTS_SCALAR_FLOAT32 to build it as float, which halves those buffers. Bot positions and
+          velocities stay in engine V3s, but movement rounds them to BotScalar as it writes them, so the
+          float build simulates the same as if they were stored in float.
+
+          Compare the two builds with replay_bot_recording(path, trace_path) + compare_bot_position_traces().
+
+    ====================================================================================
+*/
+
+#ifdef BOTS_SCALAR_FLOAT32
+    typedef float BotScalar;
+#else
+    typedef double BotScalar;
+#endif
+
+    inline double to_bot_precision(double value) {
+        return (double)(BotScalar)value;
+    }
+    inline V3 to_bot_precision(const V3 &value) {
+#ifdef BOTS_SCALAR_FLOAT32
+        return V3((float)value.x, (float)value.y, (float)value.z);
+#else
+        return value;
+#endif
+    }
+}
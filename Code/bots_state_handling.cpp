@@ -1,7 +1,20 @@
 #include "bots_state_handling.h"
+#include "bots_profiling.h"
+#include <chrono>
 
 namespace bots {
 
+	const double TRANSITION_DISTANCE_BAND_SIZE = 100.0;
+	const size_t RECENT_STATEMACHINE_STATES_MAX = 32;
+
+	const unsigned int BEHAVIOR_LOD_INTERVALS[BehaviorLodCount] = { 1, 2, 4, 8 };
+	const double BEHAVIOR_LOD_DISTANCES[BehaviorLodCount - 1] = { 1500.0, 3000.0, 6000.0 }; // Max distance to the nearest player for Full, Near and Far.
+	const double BEHAVIOR_LOD_OUT_OF_SIGHT_TIME = 5.0;		// Drop one extra tier once no player has seen us for this long.
+	const double BEHAVIOR_LOD_FULL_RATE_DURATION = 3.0;
+
+	bool profile_transition_conditions = false;
+	bool behavior_lod_enabled = false;
+
 	std::unordered_map<bots::BotType, std::unordered_map<unsigned int, bots::State>> &get_bot_state_map() {
 		static std::unordered_map<bots::BotType, std::unordered_map<unsigned int, bots::State>> bot_state_map;
 		return bot_state_map;
@@ -64,18 +77,122 @@ namespace bots {
 		StateMachine &sm = agent.bot_state.state_machine;
 
 #ifdef PRIVATE_BUILD
-		agent.bot_state.recent_statemachine_states.push_front(sm.current_state);
+		std::deque<unsigned int> &recent_states = agent.bot_state.recent_statemachine_states;
+		recent_states.push_front(sm.current_state);
+		if (recent_states.size() > RECENT_STATEMACHINE_STATES_MAX) {
+			recent_states.pop_back();
+		}
 #endif
 
-		is_state_valid(bot_type, sm.current_state) ? state_definitions.at(sm.current_state).exit(agent) : void();
+		const bool profile = profile_bot_states;
+		if (profile) {
+			profile_state_transition(agent, sm.current_state, target_state, sm.time_in_state);
+		}
+
+		if (is_state_valid(bot_type, sm.current_state)) {
+			double exit_start = profile ? get_profiler_time() : 0.0;
+			state_definitions.at(sm.current_state).exit(agent);
+
+			if (profile) {
+				profile_state_exit(bot_type, sm.current_state, get_profiler_time() - exit_start, sm.time_in_state);
+			}
+		}
+
 		sm.previous_state = sm.current_state;
 		sm.current_state = target_state;
 		sm.time_in_state = 0;
+		sm.transition_evaluated_time.fill(-1.0);
+
+		double enter_start = profile ? get_profiler_time() : 0.0;
 		state_definitions.at(target_state).enter(agent);
 
+		if (profile) {
+			profile_state_enter(bot_type, target_state, get_profiler_time() - enter_start);
+		}
+
 		return true;
 	}
 
+	void _set_input_changed(StateMachine &sm, TransitionInput input, double now) {
+		for (unsigned int i = 0; i < TransitionInputCount; i++) {
+			if (input & (1u << i)) { sm.input_changed_time[i] = now; }
+		}
+	}
+	void _update_transition_inputs(Agent &agent, double now) {
+
+		BotState &bot_state = agent.bot_state;
+		StateMachine &sm = bot_state.state_machine;
+		TransitionInputSnapshot &snapshot = sm.input_snapshot;
+
+		unsigned int status_effect_mask = 0;
+		for (int i = 0; i < StatusEffectCount; i++) {
+			status_effect_mask |= bot_state.movement.movement_effects[i].active ? (1u << i) : 0;
+		}
+
+		const BotTarget *target = get_current_bot_target(agent);
+		const int distance_band = target ? (int)(sqrt(target->distance_squared) / TRANSITION_DISTANCE_BAND_SIZE) : -1;
+
+		if (snapshot.target_agent_id != bot_state.target_agent_id) {
+			snapshot.target_agent_id = bot_state.target_agent_id;
+			_set_input_changed(sm, TransitionInput_Target, now);
+		}
+		if (snapshot.hp != agent.battle_state.hp) {
+			snapshot.hp = agent.battle_state.hp;
+			_set_input_changed(sm, TransitionInput_Health, now);
+		}
+		if (snapshot.status_effect_mask != status_effect_mask) {
+			snapshot.status_effect_mask = status_effect_mask;
+			_set_input_changed(sm, TransitionInput_StatusEffect, now);
+		}
+		if (snapshot.distance_band != distance_band) {
+			snapshot.distance_band = distance_band;
+			_set_input_changed(sm, TransitionInput_DistanceBand, now);
+		}
+	}
+	bool has_input_driven_transitions(const State &state) {
+		for (const StateTransition &transition : state.transitions) {
+			if (transition.inputs & ~TransitionInput_TimeInState) { return true; }
+		}
+		return false;
+	}
+	bool _should_evaluate_transition(const StateMachine &sm, const StateTransition &transition, size_t index, double now) {
+
+		if (index >= MAX_TRACKED_TRANSITIONS) { return true; }
+
+		const double last_evaluated = sm.transition_evaluated_time[index];
+		if (last_evaluated < 0.0) { return true; }
+
+		if (transition.min_interval > 0.0 && now - last_evaluated < transition.min_interval) { return false; }
+
+		if (transition.inputs == TransitionInput_Always || (transition.inputs & TransitionInput_TimeInState)) { return true; }
+
+		// The condition returned false last time, it can only change if one of its inputs did.
+		for (unsigned int i = 0; i < TransitionInputCount; i++) {
+			if ((transition.inputs & (1u << i)) && sm.input_changed_time[i] > last_evaluated) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+	bool _evaluate_transition(Agent &agent, StateTransition &transition) {
+
+		TransitionStats &stats = transition.stats;
+		stats.evaluations++;
+
+		bool passed = false;
+		if (profile_transition_conditions) {
+			auto start = std::chrono::steady_clock::now();
+			passed = transition.condition(agent);
+			stats.total_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		} else {
+			passed = transition.condition(agent);
+		}
+
+		stats.passed += passed;
+		return passed;
+	}
+
 	void _state_machine_update(Agent &agent, double dt) {
 
 		BotType bot_type = agent.bot_state.type;
@@ -96,13 +213,38 @@ namespace bots {
 		}
 
 		// Update our current state
-		const State &state = state_definitions.at(sm.current_state);
+		State &state = state_definitions.at(sm.current_state);
+		const unsigned int updated_state = sm.current_state;
+		const bool profile = profile_bot_states;
+
+		double update_start = profile ? get_profiler_time() : 0.0;
 		StateStatus status = state.update(agent, dt);
 		sm.time_in_state += dt;
 
+		if (profile) {
+			profile_state_update(bot_type, updated_state, get_profiler_time() - update_start);
+		}
+
+		// Sampled after the update since states commonly retarget within it.
+		const double now = timing::elapsed_time_seconds;
+		if (state.tracks_transition_inputs) {
+			_update_transition_inputs(agent, now);
+		}
+
 		// Check if any transition gives thumbs up for state change.
-		for (const StateTransition &transition : state.transitions) {
-			if (transition.condition(agent)) {
+		for (size_t i = 0; i < state.transitions.size(); i++) {
+			StateTransition &transition = state.transitions[i];
+
+			if (!_should_evaluate_transition(sm, transition, i, now)) {
+				transition.stats.skipped++;
+				continue;
+			}
+
+			if (i < MAX_TRACKED_TRANSITIONS) {
+				sm.transition_evaluated_time[i] = now;
+			}
+
+			if (_evaluate_transition(agent, transition)) {
 				change_state(agent, transition.to_state);
 				return;
 			}
@@ -130,6 +272,64 @@ namespace bots {
 			} break;
 		}
 	}
+	BehaviorLodTier update_behavior_lod(Agent &agent, const std::vector<Agent *> &players) {
+
+		BotState &bot_state = agent.bot_state;
+		BehaviorLod &lod = bot_state.behavior_lod;
+		const double now = timing::elapsed_time_seconds;
+
+		// Taking damage or entering combat always promotes us back to full rate right away.
+		bool took_damage = bot_state.last_damaged_time > lod.seen_damaged_time;
+		bool entered_combat = bot_state.engaged_combat && !lod.seen_engaged_combat;
+		lod.seen_damaged_time = bot_state.last_damaged_time;
+		lod.seen_engaged_combat = bot_state.engaged_combat;
+
+		if (took_damage || entered_combat) {
+			lod.full_rate_until = now + BEHAVIOR_LOD_FULL_RATE_DURATION;
+		}
+
+		if (now < lod.full_rate_until) {
+			lod.tier = BehaviorLod_Full;
+			return lod.tier;
+		}
+
+		double nearest_distance_sqrd = DBL_MAX;
+		for (Agent *player : players) {
+			if (!player) { continue; }
+			nearest_distance_sqrd = MIN(nearest_distance_sqrd, (player->battle_state.position - agent.battle_state.position).length_squared());
+		}
+
+		unsigned int tier = BehaviorLod_Distant;
+		for (unsigned int i = 0; i < BehaviorLodCount - 1; i++) {
+			if (nearest_distance_sqrd <= BEHAVIOR_LOD_DISTANCES[i] * BEHAVIOR_LOD_DISTANCES[i]) {
+				tier = i;
+				break;
+			}
+		}
+
+		if (bot_state.time_outside_player_sight > BEHAVIOR_LOD_OUT_OF_SIGHT_TIME) {
+			tier = MIN(tier + 1, (unsigned int)BehaviorLod_Distant);
+		}
+
+		lod.tier = static_cast<BehaviorLodTier>(tier);
+		return lod.tier;
+	}
+	bool should_update_behavior(Agent &agent, unsigned int turn, double dt, OUT double &behavior_dt) {
+
+		BehaviorLod &lod = agent.bot_state.behavior_lod;
+		lod.accumulated_dt += dt;
+
+		// Offset by id so bots of the same tier don't all update on the same tick.
+		const unsigned int interval = BEHAVIOR_LOD_INTERVALS[lod.tier];
+		if (lod.tier != BehaviorLod_Full && (turn + agent.player_id) % interval != 0) {
+			return false;
+		}
+
+		behavior_dt = lod.accumulated_dt;
+		lod.accumulated_dt = 0.0;
+		return true;
+	}
+
 	void update_behavior(Agent &agent, double dt) {
 
 		if (bots::BotDefinition *bot_def = bots::get_bot_definition(agent.bot_state.type)) {
@@ -149,4 +349,31 @@ namespace bots {
 		}
 	}
 
-}
\ No newline at end of file
+	void reset_transition_stats() {
+		for (auto &[type, state_map] : get_bot_state_map()) {
+			for (auto &[state_id, state] : state_map) {
+				for (StateTransition &transition : state.transitions) {
+					transition.stats = TransitionStats();
+				}
+			}
+		}
+	}
+	void print_transition_stats(BotType type) {
+
+		GlobalStateMap &bot_state_map = get_bot_state_map();
+		GlobalStateMap::iterator it = bot_state_map.find(type);
+		if (it == bot_state_map.end()) { return; }
+
+		for (auto &[state_id, state] : it->second) {
+			for (const StateTransition &transition : state.transitions) {
+				const TransitionStats &stats = transition.stats;
+				const State *to_state = get_state_by_id(type, transition.to_state);
+				double avg_us = stats.evaluations ? (stats.total_time / stats.evaluations) * 1000000.0 : 0.0;
+
+				PRINT(std::string(state.name) + " -> " + (to_state ? to_state->name : "invalid") +
+					": evaluated " + toString(stats.evaluations) + ", skipped " + toString(stats.skipped) +
+					", passed " + toString(stats.passed) + ", avg " + toString(avg_us) + " us");
+			}
+		}
+	}
+}
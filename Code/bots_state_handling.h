@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 
 struct Agent;
 
@@ -30,20 +31,49 @@ namespace bots {
         get_bot_state_map()[BotType(type)][enum_state] = State(#enum_state, enter, update, exit, success_state); \
 	    State& new_state = get_bot_state_map()[BotType(type)][enum_state]; \
 	    new_state.transitions.insert(new_state.transitions.end(), { __VA_ARGS__ } ); \
+	    new_state.tracks_transition_inputs = has_input_driven_transitions(new_state); \
     } 
 
     // Used within ADD_STATE scope to add a possible state to transition to based on the specified condition.
 #define ADD_TRANSITION(to_state, condition) \
       { to_state, condition }
 
+    // Same as ADD_TRANSITION but declares which inputs (TransitionInput flags) the condition reads.
+    // The condition is skipped while none of them have changed since it last returned false,
+    // and is never evaluated more often than min_interval seconds (0 = every tick).
+#define ADD_TRANSITION_EX(to_state, condition, inputs, min_interval) \
+      { to_state, condition, inputs, min_interval }
+
     enum StateStatus {
         Running,    // Keeps the current state
         Success,    // Progress to the next state.
         Failure     // Progress to the fallback state.
     };
+    // BitFlag mask. The inputs a transition condition depends on.
+    enum TransitionInput : unsigned int {
+        TransitionInput_Always = 0,             // Nothing declared, evaluated every tick.
+        TransitionInput_Target = 1 << 0,        // Current target changed.
+        TransitionInput_Health = 1 << 1,        // Our hp changed.
+        TransitionInput_TimeInState = 1 << 2,   // Changes every tick, only useful together with min_interval.
+        TransitionInput_StatusEffect = 1 << 3,  // A StatusEffect got applied or cleared.
+        TransitionInput_DistanceBand = 1 << 4,  // Distance to our target moved into another band (TRANSITION_DISTANCE_BAND_SIZE).
+        TransitionInputCount = 5
+    };
+
+    // Shared by all bots of the same type, counts how often a condition runs and what it costs.
+    struct TransitionStats {
+        unsigned long long evaluations = 0;
+        unsigned long long skipped = 0;         // Skipped due to unchanged inputs or min_interval.
+        unsigned long long passed = 0;          // Times the condition returned true.
+        double total_time = 0.0;                // Seconds spent in the condition (only measured if profile_transition_conditions).
+    };
+
     struct StateTransition {
         unsigned int to_state;                // The enum state to transition into.
         bool (*condition)(Agent &) = nullptr; // Lambda function to check if we should transition
+        unsigned int inputs = TransitionInput_Always;
+        double min_interval = 0.0;
+        TransitionStats stats;
     };
     struct State {
         const char *name = "not set";
@@ -53,12 +83,52 @@ namespace bots {
                                                                                                              
         unsigned int success_state = 0; // The state we transition into if "Success" was returned by the current state.
         std::vector<StateTransition> transitions; // Container of possible transitions for a state. assign transitions by macro ADD_TRANSITION.
+        bool tracks_transition_inputs = false;    // Set by ADD_STATE if an ADD_TRANSITION_EX transition declares inputs, otherwise the inputs aren't sampled.
+    };
+    // Last observed values of the transition inputs, used to detect what changed since the previous tick.
+    struct TransitionInputSnapshot {
+        unsigned int target_agent_id = UINT_MAX;
+        double hp = -1.0;
+        unsigned int status_effect_mask = 0;
+        int distance_band = -1;
     };
+
+    const unsigned int MAX_TRACKED_TRANSITIONS = 16; // Transitions past this count in a state are always evaluated.
+
     struct StateMachine {
         unsigned int previous_state = UINT_MAX;
         unsigned int current_state = UINT_MAX;
         double time_in_state = 0;   // Incremented by dt each tick while active.
+
+        TransitionInputSnapshot input_snapshot;
+        std::array<double, TransitionInputCount> input_changed_time = {};                   // When each TransitionInput last changed.
+        std::array<double, MAX_TRACKED_TRANSITIONS> transition_evaluated_time = {};         // When each transition of the current state last ran, < 0 if never.
+    };
+
+    // Enables measuring the time spent in transition conditions (counts are always tracked).
+    extern bool profile_transition_conditions;
+
+    // Behavior update rate tiers, picked from the distance to the nearest player and visibility.
+    enum BehaviorLodTier : unsigned int {
+        BehaviorLod_Full,       // Every tick.
+        BehaviorLod_Near,       // Every 2nd tick.
+        BehaviorLod_Far,        // Every 4th tick.
+        BehaviorLod_Distant,    // Every 8th tick.
+        BehaviorLodCount
     };
+    struct BehaviorLod {
+        BehaviorLodTier tier = BehaviorLod_Full;
+        double accumulated_dt = 0.0;        // dt gathered since the behavior last ran, passed on as the dt of the next update.
+        double seen_damaged_time = 0.0;     // last_damaged_time when we last checked, used to detect new damage.
+        double full_rate_until = 0.0;       // Kept at full rate until this time after taking damage or engaging combat.
+        bool seen_engaged_combat = false;
+    };
+
+    // Enables reduced rate behavior updates for bots far away from / out of sight of players.
+    extern bool behavior_lod_enabled;
+
+    BehaviorLodTier update_behavior_lod(Agent &agent, const std::vector<Agent *> &players);
+    bool should_update_behavior(Agent &agent, unsigned int turn, double dt, OUT double &behavior_dt);
 
     unsigned int get_bot_fallback_state(bots::BotType bot_type);
     void set_bot_fallback_state(bots::BotType bot_type, unsigned int fallback_state);
@@ -68,6 +138,11 @@ namespace bots {
 
     bool change_state(Agent &agent, unsigned int target_state, bool force_transition = false);
     bool is_state_valid(BotType type, unsigned int state);
+    // True if any transition of the state declares TransitionInputs, i.e. needs them sampled every update.
+    bool has_input_driven_transitions(const State &state);
 
     void update_behavior(Agent &agent, double dt);
+
+    void reset_transition_stats();
+    void print_transition_stats(BotType type);
 }
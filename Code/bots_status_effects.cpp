@@ -7,6 +7,94 @@ namespace bots {
 	const double MAX_KNOCKBACK_VELOCITY = 800.0;
 	const double MAX_KNOCKBACK_TIME = 5.0;
 
+	bool closed_form_status_effects = false;
+
+	bool _is_scalar_effect(StatusEffectType type) {
+		return type == Speed || type == Slow || type == Stagger;
+	}
+	double _get_allowed_speed_pct(const Movement &movement, double time) {
+
+		double allowed_speed_pct = 1.0;
+
+		for (int i = 0; i < StatusEffectCount; ++i) {
+			const StatusEffect &effect = movement.movement_effects[i];
+			if (!effect.active) continue;
+
+			switch (effect.type) {
+				case Speed: //Fallthrough
+				case Slow:
+				case Stagger:
+					allowed_speed_pct *= get_effect_scalar(effect, time);
+					break;
+
+				case Immobilize: //Fallthrough
+				case TimeStop:
+					return 0.0;
+			}
+		}
+
+		return allowed_speed_pct;
+	}
+	void _schedule_effect_expiry(Agent &bot, const StatusEffect &effect) {
+
+		if (!closed_form_status_effects) { return; }
+
+		StatusEffectExpiry expiry;
+		expiry.expire_time = effect.start_time + effect.duration;
+		expiry.start_time = effect.start_time;
+		expiry.agent_id = bot.player_id;
+		expiry.type = effect.type;
+		get_status_effect_expiry_queue().push(expiry);
+
+		// effective_max_speed is only a snapshot in closed form mode, refresh it when the set of effects changes.
+		recompute_movement_speed(bot);
+	}
+
+	StatusEffectExpiryQueue &get_status_effect_expiry_queue() {
+		static StatusEffectExpiryQueue expiry_queue;
+		return expiry_queue;
+	}
+	void update_status_effect_expiries(double current_time) {
+
+		StatusEffectExpiryQueue &expiry_queue = get_status_effect_expiry_queue();
+
+		while (!expiry_queue.empty() && expiry_queue.top().expire_time <= current_time) {
+			const StatusEffectExpiry expiry = expiry_queue.top();
+			expiry_queue.pop();
+
+			Agent *bot = gamestate::get_agent_by_id(netserver::state, expiry.agent_id);
+			if (!bot || !bot->is_bot_server) { continue; }
+
+			// Skip if the effect has been cleared or re-applied since this entry was scheduled.
+			const StatusEffect &effect = bot->bot_state.movement.movement_effects[expiry.type];
+			if (!effect.active || effect.start_time != expiry.start_time) { continue; }
+			if (effect.start_time + effect.duration != expiry.expire_time) { continue; }
+
+			clear_status_effect(*bot, expiry.type);
+		}
+	}
+	double get_effect_scalar(const StatusEffect &effect, double time) {
+
+		if (!closed_form_status_effects) { return effect.current_scalar; }
+
+		switch (effect.decay) {
+			case StatusEffectDecay_Linear: {
+				if (effect.duration <= 0.0) { return 1.0; }
+
+				double t = CLAMP(1.0 - ((time - effect.start_time) / effect.duration), 0.0, 1.0);
+				return 1.0 + (effect.start_scalar - 1.0) * t;
+			}
+		}
+
+		return effect.start_scalar;
+	}
+	double get_effective_max_speed(const Movement &movement) {
+
+		if (!closed_form_status_effects) { return movement.effective_max_speed; }
+
+		return movement.max_speed * _get_allowed_speed_pct(movement, timing::elapsed_time_seconds);
+	}
+
 	bool is_immune_to_effect(Agent &bot, StatusEffectType effect_type) {
 		return bot.bot_state.movement.effect_multipliers[effect_type] <= 0.0;
 	}
@@ -15,7 +103,7 @@ namespace bots {
 		StatusEffect &effect = bot.bot_state.movement.movement_effects[type];
 		if (!effect.active) { return false; }
 
-		double current_magnitude = effect.current_scalar;
+		double current_magnitude = get_effect_scalar(effect, timing::elapsed_time_seconds);
 
 		switch (type) {
 
@@ -34,28 +122,7 @@ namespace bots {
 	}
 	void recompute_movement_speed(Agent &agent) {
 		Movement &movement = agent.bot_state.movement;
-
-		double allowed_speed_pct = 1.0;
-
-		for (int i = 0; i < StatusEffectCount; ++i) {
-			const StatusEffect &effect = movement.movement_effects[i];
-			if (!effect.active) continue;
-
-			switch (effect.type) {
-				case Speed: //Fallthrough
-				case Slow:
-				case Stagger:
-					allowed_speed_pct *= effect.current_scalar;
-					break;
-
-				case Immobilize: //Fallthrough
-				case TimeStop:
-					allowed_speed_pct = 0.0;
-					break;
-			}
-		}
-
-		movement.effective_max_speed = movement.max_speed * allowed_speed_pct;
+		movement.effective_max_speed = movement.max_speed * _get_allowed_speed_pct(movement, timing::elapsed_time_seconds);
 	}
 
 	void update_held_by_agent_effect(Agent &agent, double dt) {
@@ -96,6 +163,9 @@ namespace bots {
 
 			if (!effect.active) continue;
 
+			// Scalar effects are evaluated lazily and expired by the expiry queue.
+			if (closed_form_status_effects && _is_scalar_effect(effect.type)) continue;
+
 			switch (effect.type) {
 
 				case Knockback: {
@@ -123,7 +193,9 @@ namespace bots {
 			effect.elapsed_time += dt;
 		}
 
-		recompute_movement_speed(agent);
+		if (!closed_form_status_effects) {
+			recompute_movement_speed(agent);
+		}
 	}
 	void update_knockback_effect(Agent &agent, double dt, OUT V3 &velocity) {
 
@@ -147,7 +219,7 @@ namespace bots {
 		agent.collidable = true;
 
 		V3 ground_pos;
-		if (levels::trace_ground(*game::level, agent.battle_state.position, ground_pos) &&
+		if (bot_trace_ground(agent.battle_state.position, ground_pos) &&
 			agent.battle_state.position.distance(ground_pos) < 27) {
 			movement.grounded = knockbac_velocity.y <= 0;
 		} else {
@@ -303,17 +375,26 @@ namespace bots {
 		state[type].duration = 0;
 		state[type].base_scalar = 1;
 		state[type].current_scalar = 1;
+		state[type].start_scalar = 1;
+		state[type].start_time = 0;
+		state[type].decay = StatusEffectDecay_None;
 		state[type].vector = V3::ZERO;
 
 		if (type == HeldByAgent) {
 			bot.bot_state.movement.snap_to_navmesh = true;
 		}
 
+		if (closed_form_status_effects && _is_scalar_effect(type)) {
+			recompute_movement_speed(bot);
+		}
+
 		return false;
 	}
 
 	bool apply_held_by_agent_effect(Agent &bot, unsigned int held_by_agent_id, StatusEffectVisuals *visuals) {
 
+		record_bot_replay_effect(bot, BotReplayEffect_HeldByAgent, 0.0, 0.0, V3::ZERO, held_by_agent_id);
+
 		BotDefinition *def = get_bot_definition(bot.bot_state.type);
 		if (!def || def->interact_points.empty()) { return false; }
 
@@ -327,6 +408,8 @@ namespace bots {
 
 		if (!found_pickup_interact_point) { return false; }
 
+		wake_bot(bot);
+
 		Movement &movement = bot.bot_state.movement;
 		movement.snap_to_navmesh = false;
 
@@ -342,6 +425,8 @@ namespace bots {
 	}
 	bool apply_immobilize(Agent &bot, double duration, StatusEffectVisuals *visuals) {
 		
+		record_bot_replay_effect(bot, BotReplayEffect_Immobilize, duration, 0.0);
+
 		Movement &movement = bot.bot_state.movement;
 		double effectivness = movement.effect_multipliers[Immobilize];
 		const double scaled_duration = duration * effectivness;
@@ -351,6 +436,8 @@ namespace bots {
 		StatusEffect &effect = movement.movement_effects[Immobilize];
 		if (scaled_duration < effect.duration) { return false; }
 
+		wake_bot(bot);
+
 		effect.type = Immobilize;
 		effect.duration = duration * effectivness;
 		effect.elapsed_time = 0.0;
@@ -363,6 +450,8 @@ namespace bots {
 	}
 	bool apply_speed_effect(Agent &bot, double duration, double speed_pct, StatusEffectVisuals *visuals) {
 
+		record_bot_replay_effect(bot, BotReplayEffect_Speed, duration, speed_pct);
+
 		Movement &movement = bot.bot_state.movement;
 		double effectivness = movement.effect_multipliers[Speed];
 		double new_speed_multiplier = (1.0 + speed_pct) * effectivness;
@@ -372,19 +461,28 @@ namespace bots {
 		if (is_less_effective_than_current(bot, Speed, new_speed_multiplier)) { return false; }
 
 
+		wake_bot(bot);
+
 		StatusEffect &effect = movement.movement_effects[Speed];
 		effect.type = Speed;
 		effect.duration = duration * effectivness;
 		effect.elapsed_time = 0;
 		effect.base_scalar = new_speed_multiplier;
 		effect.current_scalar = effect.base_scalar;
+		effect.start_scalar = effect.current_scalar;
+		effect.start_time = timing::elapsed_time_seconds;
+		effect.decay = StatusEffectDecay_Linear;
 		effect.vfx_tag = visuals ? visuals->attached_vfx_tag : "";
 		effect.active = true;
 
+		_schedule_effect_expiry(bot, effect);
+
 		return true;
 	}
 	bool apply_slow_effect(Agent &bot, double duration, double slow_pct, StatusEffectVisuals *visuals) {
 
+		record_bot_replay_effect(bot, BotReplayEffect_Slow, duration, slow_pct);
+
 		Movement &movement = bot.bot_state.movement;
 		double effectivness = movement.effect_multipliers[Slow];
 		const double scaled_slow_pct = CLAMP(slow_pct * effectivness, 0, 1); // Avoid negative slow %
@@ -392,19 +490,28 @@ namespace bots {
 		if (is_immune_to_effect(bot, Slow)) { return false; }
 		if (is_less_effective_than_current(bot, Slow, scaled_slow_pct)) { return false; }
 
+		wake_bot(bot);
+
 		StatusEffect &effect = movement.movement_effects[Slow];
 		effect.type = Slow;
 		effect.duration = duration * effectivness;
 		effect.elapsed_time = 0.0;
 		effect.base_scalar = scaled_slow_pct; 
 		effect.current_scalar = (1.0 - effect.base_scalar); // current_scalar tracks the speed_pct_allowed
+		effect.start_scalar = effect.current_scalar;
+		effect.start_time = timing::elapsed_time_seconds;
+		effect.decay = StatusEffectDecay_Linear;
 		effect.vfx_tag = visuals ? visuals->attached_vfx_tag : "";
 		effect.active = true;
 
+		_schedule_effect_expiry(bot, effect);
+
 		return true;
 	}
 	bool apply_stagger_effect(Agent &bot, double duration, double slow_pct, StatusEffectVisuals *visuals) {
 
+		record_bot_replay_effect(bot, BotReplayEffect_Stagger, duration, slow_pct);
+
 		// Lazy way of disabling stagger on Elites and bosses, should probably be done thru script instead.
 		if (bot.bot_state.difficulty_type == DifficultyType_Boss || bot.bot_state.difficulty_type == DifficultyType_Elite) { return false; }
 
@@ -415,19 +522,28 @@ namespace bots {
 		if (is_immune_to_effect(bot, Stagger)) { return false; }
 		if (is_less_effective_than_current(bot, Stagger, scaled_slow_pct)) { return false; }
 
+		wake_bot(bot);
+
 		StatusEffect &effect = movement.movement_effects[Stagger];
 		effect.type = Stagger;
 		effect.duration = duration * effectivness;
 		effect.elapsed_time = 0.0;
 		effect.base_scalar = scaled_slow_pct; 
 		effect.current_scalar = (1.0 - effect.base_scalar); // current_scalar tracks the speed_pct_allowed
+		effect.start_scalar = effect.current_scalar;
+		effect.start_time = timing::elapsed_time_seconds;
+		effect.decay = StatusEffectDecay_Linear;
 		effect.vfx_tag = visuals ? visuals->attached_vfx_tag : "";
 		effect.active = true;
 
+		_schedule_effect_expiry(bot, effect);
+
 		return true;
 	}
 	bool apply_knockback(Agent &bot, const V3 &knockback_velocity, StatusEffectVisuals *visuals) {
 
+		record_bot_replay_effect(bot, BotReplayEffect_Knockback, 0.0, 0.0, knockback_velocity);
+
 		Movement &movement = bot.bot_state.movement;
 		movement.snap_to_navmesh = false;
 		double effectivness = movement.effect_multipliers[Knockback];
@@ -436,6 +552,8 @@ namespace bots {
 		if(movement.flying) { return false; }
 		if (is_immune_to_effect(bot, Knockback)) { return false; }
 
+		wake_bot(bot);
+
 		StatusEffect &effect = movement.movement_effects[Knockback];
 		effect.type = Knockback;
 		effect.vector = knockback_velocity * effectivness;
@@ -452,6 +570,8 @@ namespace bots {
 	}
 	bool apply_timestop(Agent &bot, double duration, StatusEffectVisuals *visuals) {
 
+		record_bot_replay_effect(bot, BotReplayEffect_Timestop, duration, 0.0);
+
 		Movement &movement = bot.bot_state.movement;
 		double effectivness = movement.effect_multipliers[TimeStop];
 		const double scaled_duration = duration * effectivness;
@@ -461,6 +581,8 @@ namespace bots {
 		StatusEffect &effect = movement.movement_effects[TimeStop];
 		if (scaled_duration < effect.duration) { return false; } // Ignore a less effective one
 
+		wake_bot(bot);
+
 		effect.type = TimeStop;
 		effect.duration = scaled_duration;
 		effect.elapsed_time = 0.0;
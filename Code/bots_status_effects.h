@@ -1,7 +1,10 @@
 #pragma once
+#include <queue>
 
 namespace bots {
 
+    struct Movement;
+
     enum StatusEffectType {
         Knockback,      // Fully locks the Movement.
         Immobilize,     // Fully locks the Movement.
@@ -13,6 +16,12 @@ namespace bots {
         StatusEffectCount
     };
 
+    // How the strength of an effect changes over its duration.
+    enum StatusEffectDecay {
+        StatusEffectDecay_None,     // Holds start_scalar for the full duration.
+        StatusEffectDecay_Linear,   // Linearly fades from start_scalar back to 1.0 (no effect) over the duration.
+    };
+
     // Ensures that the attached VFX with the given tag gets removed once the StatusEffect expires.
     struct StatusEffectVisuals {
         std::string attached_vfx_tag = "";
@@ -28,11 +37,36 @@ namespace bots {
         double duration = 0;
         double elapsed_time = 0;
         double base_scalar = 1.0;       // The initial strength of the effect. Used to interpolate the magnitude of the effect over the duration.
-        double current_scalar = 1.0;    // The current strength of the effect.
+        double current_scalar = 1.0;    // The current strength of the effect. NOTE: not updated per tick in closed form mode, use get_effect_scalar().
+        double start_scalar = 1.0;      // The speed_pct_allowed at start_time, which the decay curve starts from.
+        double start_time = 0;          // Timestamp (timing::elapsed_time_seconds) of when the effect was applied.
+        StatusEffectDecay decay = StatusEffectDecay_None;
         V3 vector = V3::ZERO;           // Generic V3, used by Physics simulation to adjust the knockback velocity over time.
         std::string vfx_tag = "";       // If tag is assigned in apply_effect function, the vfx's with this tag will be removed when the StatusEffect expires. 
     };
 
+    // Scheduled expiry of a StatusEffect, kept in a min-heap ordered by expire_time.
+    // start_time and expire_time are used to detect entries that got stale due to the effect being re-applied or cleared,
+    // start_time alone misses a re-application within the same tick.
+    struct StatusEffectExpiry {
+        double expire_time = 0;
+        double start_time = 0;
+        unsigned int agent_id = 0;
+        StatusEffectType type = StatusEffectCount;
+
+        bool operator>(const StatusEffectExpiry &other) const { return expire_time > other.expire_time; }
+    };
+    typedef std::priority_queue<StatusEffectExpiry, std::vector<StatusEffectExpiry>, std::greater<StatusEffectExpiry>> StatusEffectExpiryQueue;
+
+    // When enabled, Speed / Slow / Stagger are not interpolated each tick. Their magnitude is evaluated from
+    // start_time & decay when needed, and they are cleared by the expiry queue instead of being polled.
+    extern bool closed_form_status_effects;
+
+    StatusEffectExpiryQueue &get_status_effect_expiry_queue();
+    void update_status_effect_expiries(double current_time);
+    double get_effect_scalar(const StatusEffect &effect, double time);
+    double get_effective_max_speed(const Movement &movement);
+
     void update_status_effects(Agent &agent, double dt, OUT V3 &velocity);
     void update_knockback_effect(Agent &agent, double dt, OUT V3 &velocity);
     void update_immobilize_effect(Agent &agent, double dt, OUT V3 &velocity);
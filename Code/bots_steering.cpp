@@ -0,0 +1,197 @@
+#include "bots.h"
+
+namespace bots {
+
+	bool fast_steering = false;
+
+	const double STEERING_POLYNOMIAL_MAX_ANGLE = 1.0; // Rotations larger than this per tick fall back to sin/cos.
+
+	SteeringBatch &get_steering_batch() {
+		static SteeringBatch batch;
+		return batch;
+	}
+
+	V2 get_steering_facing(Agent &agent) {
+
+		Movement &movement = agent.bot_state.movement;
+		if (movement.steering_facing_yaw != agent.battle_state.rotation_yaw) {
+			movement.steering_facing_yaw = agent.battle_state.rotation_yaw;
+			movement.steering_facing = V2(sin(movement.steering_facing_yaw), cos(movement.steering_facing_yaw));
+		}
+		return movement.steering_facing;
+	}
+
+	void queue_steering(Agent &agent, const V3 &direction) {
+
+		V2 dir_xz(direction.x, direction.z);
+		double length_sq = dir_xz.length_squared();
+		if (length_sq <= 0.0) { return; }
+
+		dir_xz = dir_xz / sqrt(length_sq);
+
+		// Same as normalized velocity dot direction scaled by speed_pct within rotate_towards, without the normalization.
+		const Movement &movement = agent.bot_state.movement;
+		double velocity_alignment = (movement.velocity.x * dir_xz.x + movement.velocity.z * dir_xz.y) / MAX(get_effective_max_speed(movement), 1.0);
+
+		SteeringBatch &batch = get_steering_batch();
+		batch.agents.push_back(&agent);
+		batch.dir_x.push_back(dir_xz.x);
+		batch.dir_z.push_back(dir_xz.y);
+		batch.velocity_alignment.push_back(velocity_alignment);
+	}
+
+	double fast_atan2(double y, double x) {
+
+		// Minimax polynomial for atan on [0, 1], max error ~1e-5 rad.
+		const double abs_x = abs(x);
+		const double abs_y = abs(y);
+		const double a = MIN(abs_x, abs_y) / MAX(MAX(abs_x, abs_y), DBL_MIN);
+		const double s = a * a;
+		double r = ((((-0.01172120 * s + 0.05265332) * s - 0.11643287) * s + 0.19354346) * s - 0.33262347) * s * a + 0.99997726 * a;
+
+		r = abs_y > abs_x ? TRIG_HALF_PI - r : r;
+		r = x < 0.0 ? TRIG_PI - r : r;
+		return y < 0.0 ? -r : r;
+	}
+
+	void update_steering_batch(double dt) {
+
+		SteeringBatch &batch = get_steering_batch();
+		const size_t count = batch.agents.size();
+
+		for (size_t i = 0; i < count; i++) {
+			Agent &agent = *batch.agents[i];
+			Movement &movement = agent.bot_state.movement;
+			const V2 facing = get_steering_facing(agent);
+
+			// Signed angle from facing to the target direction, in the same yaw convention as normal_to_nautical.
+			const double sin_delta = batch.dir_x[i] * facing.y - batch.dir_z[i] * facing.x;
+			const double cos_delta = batch.dir_x[i] * facing.x + batch.dir_z[i] * facing.y;
+			const double yaw_delta = fast_atan2(sin_delta, cos_delta);
+
+			const double extra_rotation_speed = CLAMP(batch.velocity_alignment[i], 0.0, 1.0);
+			const double fast_speed = movement.rotation_speed + extra_rotation_speed;
+			const double slow_speed = movement.rotation_speed * 0.4;
+			const double yaw_smoothing_speed = fast_speed + (slow_speed - fast_speed) * (abs(yaw_delta) / TRIG_PI);
+			const double yaw_adjustment = yaw_delta * yaw_smoothing_speed * dt;
+
+			agent.battle_state.rotation_yaw += yaw_adjustment;
+			movement.steering_facing_yaw = agent.battle_state.rotation_yaw;
+
+			if (abs(yaw_adjustment) > STEERING_POLYNOMIAL_MAX_ANGLE) {
+				movement.steering_facing = V2(sin(movement.steering_facing_yaw), cos(movement.steering_facing_yaw));
+				continue;
+			}
+
+			// Rotate the cached facing by the adjustment, taylor sin/cos are plenty for the small per tick angles.
+			const double a2 = yaw_adjustment * yaw_adjustment;
+			const double s = yaw_adjustment * (1.0 - a2 / 6.0 * (1.0 - a2 / 20.0));
+			const double c = 1.0 - a2 / 2.0 * (1.0 - a2 / 12.0);
+
+			V2 rotated(facing.x * c + facing.y * s, facing.y * c - facing.x * s);
+			movement.steering_facing = rotated / sqrt(rotated.length_squared());
+		}
+
+		batch.agents.clear();
+		batch.dir_x.clear();
+		batch.dir_z.clear();
+		batch.velocity_alignment.clear();
+	}
+
+	// dot >= cos_half_width * length, without taking the square root of length_sq.
+	bool _dot_within_cos(double dot, double length_sq, double cos_half_width) {
+
+		if (length_sq <= 0.0) { return cos_half_width <= 0.0; }
+
+		const double threshold_sq = cos_half_width * cos_half_width * length_sq;
+		if (cos_half_width >= 0.0) {
+			return dot >= 0.0 && dot * dot >= threshold_sq;
+		}
+		return dot >= 0.0 || dot * dot <= threshold_sq;
+	}
+	bool within_cone_cos(const V3 &origin, const V3 &target, const V3 &cone_dir, double cos_half_width, double cone_length) {
+
+		const V3 to_target = target - origin;
+		const double length_sq = to_target.length_squared();
+		if (length_sq > cone_length * cone_length) { return false; }
+
+		return _dot_within_cos(to_target.dot(cone_dir), length_sq, cos_half_width);
+	}
+	bool within_cone_xz_cos(const V3 &origin, const V3 &target, const V3 &cone_dir, double cos_half_width, double cone_length) {
+
+		const V2 to_target(target.x - origin.x, target.z - origin.z);
+		const V2 dir_xz(cone_dir.x, cone_dir.z);
+
+		const double length_sq = to_target.length_squared();
+		if (length_sq > cone_length * cone_length) { return false; }
+
+		return _dot_within_cos(to_target.dot(dir_xz), length_sq * dir_xz.length_squared(), cos_half_width);
+	}
+	bool is_point_in_agent_view_cos(Agent &agent, const V3 &point, double cos_vision_width) {
+
+		const V3 to_point = point - agent.battle_state.position;
+		const V3 forward = agents::get_agent_forward(agent, false);
+
+		return _dot_within_cos(forward.dot(to_point), to_point.length_squared(), cos_vision_width);
+	}
+
+#ifdef PRIVATE_BUILD
+	double _get_random_unit(double min, double max) {
+		return min + (max - min) * (randomizer.rand(1000000) / 1000000.0);
+	}
+	bool test_fast_steering_accuracy(int iterations) {
+
+		double max_atan2_error = 0.0;
+		double max_yaw_error = 0.0;
+		int cone_mismatches = 0;
+
+		for (int i = 0; i < iterations; i++) {
+
+			const double yaw = _get_random_unit(-TRIG_PI, TRIG_PI);
+			const V3 dir_to_target = V3(_get_random_unit(-1, 1), 0, _get_random_unit(-1, 1)).normalized_safe();
+			const double rotation_speed = _get_random_unit(1, 10);
+			const double extra_rotation_speed = _get_random_unit(0, 1);
+			const double dt = 1.0 / 30.0;
+
+			// Reference, the yaw part of rotate_towards.
+			double target_pitch, target_yaw;
+			algebra::normal_to_nautical(dir_to_target, target_yaw, target_pitch);
+			const double reference_delta = algebra::wrap_pos_neg_pi(target_yaw - yaw);
+			const double reference_speed = algebra::get_mapped_range_value(abs(reference_delta), rotation_speed + extra_rotation_speed, rotation_speed * 0.4, 0, TRIG_PI);
+			const double reference_adjustment = reference_delta * reference_speed * dt;
+
+			// Kernel.
+			const double sin_delta = dir_to_target.x * cos(yaw) - dir_to_target.z * sin(yaw);
+			const double cos_delta = dir_to_target.x * sin(yaw) + dir_to_target.z * cos(yaw);
+			const double delta = fast_atan2(sin_delta, cos_delta);
+			const double speed = (rotation_speed + extra_rotation_speed) + (rotation_speed * 0.4 - (rotation_speed + extra_rotation_speed)) * (abs(delta) / TRIG_PI);
+			const double adjustment = delta * speed * dt;
+
+			max_atan2_error = MAX(max_atan2_error, abs(fast_atan2(sin_delta, cos_delta) - atan2(sin_delta, cos_delta)));
+
+			// Both land on +-PI when facing directly away, either side is fine.
+			if (abs(abs(reference_delta) - TRIG_PI) > 1e-3) {
+				max_yaw_error = MAX(max_yaw_error, abs(adjustment - reference_adjustment));
+			}
+
+			const V3 origin(_get_random_unit(-1000, 1000), _get_random_unit(-100, 100), _get_random_unit(-1000, 1000));
+			const V3 target(_get_random_unit(-1000, 1000), _get_random_unit(-100, 100), _get_random_unit(-1000, 1000));
+			const V3 cone_dir = V3(_get_random_unit(-1, 1), _get_random_unit(-1, 1), _get_random_unit(-1, 1)).normalized_safe();
+			const double half_width = _get_random_unit(0, TRIG_PI);
+			const double length = _get_random_unit(0, 2000);
+
+			// Skip samples right on the cone edge, where rounding may go either way.
+			const V3 to_target = (target - origin).normalized_safe();
+			if (abs(to_target.dot(cone_dir) - cos(half_width)) < 1e-9) { continue; }
+
+			cone_mismatches += within_cone(origin, target, cone_dir, half_width, length) != within_cone_cos(origin, target, cone_dir, cos(half_width), length);
+			cone_mismatches += within_cone_xz(origin, target, cone_dir, half_width, length) != within_cone_xz_cos(origin, target, cone_dir, cos(half_width), length);
+		}
+
+		bool passed = max_atan2_error < 1e-4 && max_yaw_error < 1e-3 && !cone_mismatches;
+		PRINT("[Bots] Fast steering accuracy: atan2 error " + toString(max_atan2_error) + ", yaw adjustment error " + toString(max_yaw_error) +
+			", cone mismatches " + toString(cone_mismatches) + (passed ? " (passed)" : " (FAILED)"));
+		return passed;
+	}
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+struct Agent;
+
+namespace bots {
+
+/*
+    ====================================================================================
+
+          Trig free steering kernel.
+          Yaw is kept as a unit 2D facing (sin yaw, cos yaw) next to rotation_yaw, so turning towards a direction
+          only needs dot/cross products, a polynomial atan2 and one renormalization per bot. Bots queue their
+          steering during update_movement and are all rotated in one pass afterwards.
+
+          The cone helpers take a precomputed cosine and compare squared dot products, so they need no acos,
+          cos or normalization per call.
+
+    ====================================================================================
+*/
+
+    struct SteeringBatch {
+        std::vector<Agent *> agents;
+        std::vector<BotScalar> dir_x, dir_z;       // Normalized xz direction to rotate towards.
+        std::vector<BotScalar> velocity_alignment; // velocity.dot(dir) / max speed, drives the extra rotation speed.
+    };
+
+    // Enables the batched steering kernel instead of rotate_towards for bots rotating with steering.
+    extern bool fast_steering;
+
+    SteeringBatch &get_steering_batch();
+
+    // Cached (sin yaw, cos yaw) of the agent, recomputed only when rotation_yaw was changed elsewhere.
+    V2 get_steering_facing(Agent &agent);
+
+    void queue_steering(Agent &agent, const V3 &direction);
+    void update_steering_batch(double dt);
+
+    double fast_atan2(double y, double x);
+
+    // Same as within_cone / within_cone_xz / is_point_in_agent_view, with cos_half_width = cos(half width angle).
+    bool within_cone_cos(const V3 &origin, const V3 &target, const V3 &cone_dir, double cos_half_width, double cone_length);
+    bool within_cone_xz_cos(const V3 &origin, const V3 &target, const V3 &cone_dir, double cos_half_width, double cone_length);
+    bool is_point_in_agent_view_cos(Agent &agent, const V3 &point, double cos_vision_width);
+
+#ifdef PRIVATE_BUILD
+    // Compares the kernel and cone helpers against rotate_towards math and the trig based cone functions.
+    bool test_fast_steering_accuracy(int iterations = 100000);
+#endif
+}
@@ -29,7 +29,7 @@ namespace bots {
         return nullptr;
     }
 
-    BotTarget &_find_or_add_target(std::vector<BotTarget> &targets, unsigned int agent_id) {
+    BotTarget &_find_or_add_target(BotTargetList &targets, unsigned int agent_id) {
         for (BotTarget &t : targets) {
             if (t.agent_id == agent_id) return t;
         }
@@ -107,7 +107,9 @@ namespace bots {
         target_tracker_map[previous_target] -= 1;
         target_tracker_map[new_target] += 1;
 
-        if (send_target_to_client) {
+        if (send_target_to_client && batched_bot_replication) {
+            queue_bot_target(agent, bot_state.target_agent_id);
+        } else if (send_target_to_client) {
             gamestate::broadcast_property(netserver::state, PROPERTY_KEY_BOT_TARGET, bot_state.target_agent_id, agent.player_id);
         }
     }
@@ -225,25 +227,10 @@ namespace bots {
                 current.visible = false;
             } else if (perform_los_check) {
 
-
-
                 V3 bot_view_pos = agent.battle_state.position + V3(0, agents::get_agent_collision_profile(agent).radius_top, 0);
                 V3 opponent_view_pos = opponent->battle_state.position + V3(0, agents::get_agent_collision_profile(*opponent).radius_top, 0);
 
-                // Plane padding might solve issues where we retrieve LOS just around a corner(?)
-                // Try to adjust this if bots need to get around corners more before retrieving LOS.
-                double plane_padding = 0.0;
-
-                RayTrace trace;
-                levels::trace(
-                    *game::level, trace,
-                    bot_view_pos, opponent_view_pos,
-                    V3::ZERO, V3::ZERO,
-                    true, true, true, plane_padding,
-                    true, 812731223, false
-                );
-
-                current.visible = (trace.coverage >= 1.0);
+                current.visible = bot_trace_line_of_sight(bot_view_pos, opponent_view_pos);
                 if (current.visible) {
                     current.last_known_position = opponent->battle_state.position;
                     current.last_seen_time = timing::elapsed_time_seconds;
@@ -71,6 +71,9 @@ namespace bots {
         bool valid = false;                 // Wont be considered as a target if not valid.
     };
 
+    const size_t BOT_INLINE_TARGETS = 8;    // Targets stored inside BotState before spilling into the container pool.
+    typedef InlineVector<BotTarget, BOT_INLINE_TARGETS> BotTargetList;
+
     BotTarget *get_current_bot_target(Agent &agent);
     Agent *get_current_target(Agent &agent);
     Agent *update_targeting(Agent &agent, const TargetingContext &context, bool inform_client_of_target_change = false);
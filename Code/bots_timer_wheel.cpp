@@ -0,0 +1,128 @@
+#include "bots.h"
+
+namespace bots {
+
+	const double BOT_TIMER_WHEEL_RESOLUTION = 1.0 / 30.0;
+
+	bool timer_wheel_cooldowns = false;
+
+	BotTimerWheel &get_bot_timer_wheel() {
+		static BotTimerWheel wheel;
+		return wheel;
+	}
+
+	unsigned int get_bot_timer_tick(double time) {
+		// Rounded up, so an expiry never fires before its time.
+		return (unsigned int)MAX(0.0, ceil(time / BOT_TIMER_WHEEL_RESOLUTION));
+	}
+
+	unsigned int _get_current_bot_timer_tick() {
+		return (unsigned int)MAX(0.0, floor(timing::elapsed_time_seconds / BOT_TIMER_WHEEL_RESOLUTION));
+	}
+	void _fire_bot_timer(const BotTimer &timer) {
+
+		Agent *agent = gamestate::get_agent_by_id(netserver::state, timer.agent_id);
+		if (!agent) { return; }
+
+		BotAttackCooldowns &cooldowns = agent->bot_state.attack_cooldowns;
+		if (timer.ready_bit >= cooldowns.attack_count) { return; }
+
+		// Rescheduled, or the bot respawned since.
+		if (cooldowns.ready_ticks[timer.ready_bit] != timer.expire_tick) { return; }
+
+		cooldowns.ready_mask |= 1u << timer.ready_bit;
+	}
+	void _insert_bot_timer(BotTimerWheel &wheel, const BotTimer &timer) {
+
+		if (timer.expire_tick <= wheel.current_tick) {
+			_fire_bot_timer(timer);
+			return;
+		}
+
+		const unsigned int delta = timer.expire_tick - wheel.current_tick;
+		if (delta < BOT_TIMER_WHEEL_SLOTS) {
+			wheel.slots[timer.expire_tick % BOT_TIMER_WHEEL_SLOTS].push_back(timer);
+			return;
+		}
+
+		// Past the coarse wheel's range, park it in the last coarse slot and let the cascade reinsert it.
+		const unsigned int max_delta = BOT_TIMER_WHEEL_SLOTS * (BOT_TIMER_WHEEL_COARSE_SLOTS - 1);
+		const unsigned int coarse_tick = delta < max_delta ? timer.expire_tick : wheel.current_tick + max_delta;
+		wheel.coarse_slots[(coarse_tick / BOT_TIMER_WHEEL_SLOTS) % BOT_TIMER_WHEEL_COARSE_SLOTS].push_back(timer);
+	}
+	void _process_bot_timer_slot(BotTimerWheel &wheel, std::vector<BotTimer> &slot) {
+
+		// Swapped out first, reinserting can land in the slot being processed.
+		wheel.expired.clear();
+		std::swap(wheel.expired, slot);
+
+		for (const BotTimer &timer : wheel.expired) {
+			_insert_bot_timer(wheel, timer);
+		}
+	}
+
+	void update_bot_timer_wheel() {
+
+		BotTimerWheel &wheel = get_bot_timer_wheel();
+		const unsigned int now = _get_current_bot_timer_tick();
+
+		// Time going backwards (replays, perf scenarios) just restarts the wheel from there, the expiry checks keep it correct.
+		if (!wheel.started || now < wheel.current_tick) {
+			wheel.current_tick = now;
+			wheel.started = true;
+			return;
+		}
+
+		while (wheel.current_tick < now) {
+			wheel.current_tick++;
+
+			if (wheel.current_tick % BOT_TIMER_WHEEL_SLOTS == 0) {
+				_process_bot_timer_slot(wheel, wheel.coarse_slots[(wheel.current_tick / BOT_TIMER_WHEEL_SLOTS) % BOT_TIMER_WHEEL_COARSE_SLOTS]);
+			}
+			_process_bot_timer_slot(wheel, wheel.slots[wheel.current_tick % BOT_TIMER_WHEEL_SLOTS]);
+		}
+	}
+
+	unsigned char get_attack_ready_bit(Agent &agent, AttackDef &attack_def) {
+
+		BotAttackCooldowns &cooldowns = agent.bot_state.attack_cooldowns;
+
+		if (attack_def.ready_bit < cooldowns.attack_count && cooldowns.attacks[attack_def.ready_bit] == &attack_def) {
+			return attack_def.ready_bit;
+		}
+		if (cooldowns.attack_count >= BOT_MAX_TIMED_ATTACKS) { return BOT_NO_READY_BIT; }
+
+		// New attack (or one from a previous life), it starts out ready like an AttackDef that was never put on cooldown.
+		const unsigned char ready_bit = (unsigned char)cooldowns.attack_count++;
+		cooldowns.attacks[ready_bit] = &attack_def;
+		cooldowns.ready_ticks[ready_bit] = 0;
+		cooldowns.ready_mask |= 1u << ready_bit;
+		attack_def.ready_bit = ready_bit;
+		attack_def.ready_owner_id = agent.player_id;
+		return ready_bit;
+	}
+	void schedule_attack_ready(Agent &agent, unsigned char ready_bit, double available_time) {
+
+		BotAttackCooldowns &cooldowns = agent.bot_state.attack_cooldowns;
+		if (ready_bit >= cooldowns.attack_count) { return; }
+
+		BotTimer timer;
+		timer.agent_id = agent.player_id;
+		timer.expire_tick = get_bot_timer_tick(available_time);
+		timer.ready_bit = ready_bit;
+
+		cooldowns.ready_mask &= ~(1u << ready_bit);
+		cooldowns.ready_ticks[ready_bit] = timer.expire_tick;
+
+		BotTimerWheel &wheel = get_bot_timer_wheel();
+		if (!wheel.started) {
+			wheel.current_tick = _get_current_bot_timer_tick();
+			wheel.started = true;
+		}
+		_insert_bot_timer(wheel, timer);
+	}
+	void reset_attack_cooldowns(BotAttackCooldowns &cooldowns) {
+		cooldowns.attack_count = 0;
+		cooldowns.ready_mask = ~0u;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+struct Agent;
+
+namespace bots {
+
+    struct AttackDef;
+
+/*
+    ====================================================================================
+
+          Hierarchical timer wheel for attack cooldowns.
+          set_attack_on_cooldown schedules the expiry in ticks of BOT_TIMER_WHEEL_RESOLUTION.
+          Expiries within BOT_TIMER_WHEEL_SLOTS ticks go straight into the fine wheel. Later ones wait in
+          the coarse wheel and are cascaded down whenever the fine wheel wraps. Each bot's timed attacks get
+          a bit in BotAttackCooldowns::ready_mask, which the wheel sets on expiry, so attack_off_cooldown is a
+          bit test instead of time math. The bit is assigned the first time set_attack_on_cooldown(agent, attack)
+          sees the attack, after which both set_attack_on_cooldown overloads reschedule it, the only writers of
+          available_time. Attacks without a bit keep comparing available_time.
+
+          Expiries are rounded up to whole ticks, so an attack comes off cooldown on the first wheel tick at or
+          after available_time. That is up to one BOT_TIMER_WHEEL_RESOLUTION (1/30 s) later than the first frame
+          after available_time, which is when the polled comparison lets it through.
+
+          Expiries are stored as absolute ticks and checked again when their slot comes up, so a timer that
+          was rescheduled, or whose bot respawned, is dropped instead of firing early.
+
+    ====================================================================================
+*/
+
+    const size_t BOT_TIMER_WHEEL_SLOTS = 256;           // Fine wheel, one tick per slot.
+    const size_t BOT_TIMER_WHEEL_COARSE_SLOTS = 64;     // Coarse wheel, BOT_TIMER_WHEEL_SLOTS ticks per slot.
+    const size_t BOT_MAX_TIMED_ATTACKS = 16;            // Attacks past this keep polling available_time.
+    const unsigned char BOT_NO_READY_BIT = 0xFF;
+
+    struct BotAttackCooldowns {
+        const AttackDef *attacks[BOT_MAX_TIMED_ATTACKS] = {};   // Owner of each bit, a bit is reassigned if its AttackDef changed.
+        unsigned int ready_ticks[BOT_MAX_TIMED_ATTACKS] = {};   // Tick each bit is scheduled to come off cooldown at.
+        unsigned int ready_mask = ~0u;
+        unsigned int attack_count = 0;
+    };
+
+    struct BotTimer {
+        unsigned int agent_id = 0;
+        unsigned int expire_tick = 0;
+        unsigned char ready_bit = BOT_NO_READY_BIT;
+    };
+
+    struct BotTimerWheel {
+        std::vector<BotTimer> slots[BOT_TIMER_WHEEL_SLOTS];
+        std::vector<BotTimer> coarse_slots[BOT_TIMER_WHEEL_COARSE_SLOTS];
+        std::vector<BotTimer> expired;                  // Scratch for the slot being processed.
+        unsigned int current_tick = 0;
+        bool started = false;
+    };
+
+    // Enables scheduling attack cooldowns on the timer wheel instead of polling them.
+    extern bool timer_wheel_cooldowns;
+
+    BotTimerWheel &get_bot_timer_wheel();
+
+    // First tick at or after time, expiries are rounded up so they never fire early.
+    unsigned int get_bot_timer_tick(double time);
+
+    // Fires every timer up to the current time, called at the start of the bot update.
+    void update_bot_timer_wheel();
+
+    // Returns the ready bit of the attack for this bot, assigning one if needed, or BOT_NO_READY_BIT if it has to be polled.
+    unsigned char get_attack_ready_bit(Agent &agent, AttackDef &attack_def);
+    void schedule_attack_ready(Agent &agent, unsigned char ready_bit, double available_time);
+
+    void reset_attack_cooldowns(BotAttackCooldowns &cooldowns);
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <array>
+#include <string_view>
+
+namespace bots {
+
+/*
+	====================================================================================
+
+		  Compile time reflection tables generated from BOT_TYPE_LIST.
+		  Everything below is constexpr, so lookups never allocate and are safe to
+		  call from hot paths and worker threads:
+			- BOT_TYPE_INFO: BotType_COUNT sized table of per-type constants, indexed by BotType.
+			- BOT_TYPE_LOOKUP: short names sorted for a binary search string -> enum.
+
+	====================================================================================
+*/
+
+	constexpr size_t BOT_TYPE_NAME_MAX = 64;
+	constexpr std::string_view BOT_TYPE_PREFIX = "bottype_";
+
+	constexpr char bot_type_to_lower(char c) {
+		return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+
+	// Null terminated lowercase copy of a name, stored inline so it can live in a constexpr table.
+	struct BotTypeLowerName {
+		char data[BOT_TYPE_NAME_MAX] = {};
+		size_t size = 0;
+
+		constexpr std::string_view view() const { return std::string_view(data, size); }
+	};
+	constexpr BotTypeLowerName make_bot_type_lower_name(std::string_view name) {
+		BotTypeLowerName result;
+		for (size_t i = 0; i < name.size() && i < BOT_TYPE_NAME_MAX - 1; i++) {
+			result.data[i] = bot_type_to_lower(name[i]);
+			result.size++;
+		}
+		return result;
+	}
+
+	struct BotTypeInfo {
+		BotType type = BotType_None;
+		std::string_view case_name;         // "BotType_Horde"
+		std::string_view short_name;        // "Horde", without the "BotType_" identifier.
+		BotTypeLowerName lower_name;        // "bottype_horde"
+		BotTypeLowerName lower_short_name;  // "horde"
+	};
+
+#define BOT_ENUM_TO_TYPE_INFO(key, value) { key, #key, std::string_view(#key).substr(BOT_TYPE_PREFIX.size()), make_bot_type_lower_name(#key), make_bot_type_lower_name(std::string_view(#key).substr(BOT_TYPE_PREFIX.size())) },
+
+	constexpr BotTypeInfo BOT_TYPE_INFO[] = {
+		BOT_TYPE_LIST(BOT_ENUM_TO_TYPE_INFO)
+	};
+
+	constexpr bool _is_bot_type_info_indexed_by_value() {
+		for (unsigned int i = 0; i < BotType_COUNT; i++) {
+			if (BOT_TYPE_INFO[i].type != i) { return false; }
+		}
+		return true;
+	}
+	static_assert(sizeof(BOT_TYPE_INFO) / sizeof(BotTypeInfo) == BotType_COUNT, "BOT_TYPE_INFO must contain every BotType.");
+	static_assert(_is_bot_type_info_indexed_by_value(), "BOT_TYPE_LIST values must be sequential from 0 for BOT_TYPE_INFO to be indexed by BotType.");
+
+	struct BotTypeLookupEntry {
+		std::string_view lower_short_name;
+		BotType type = BotType_COUNT;
+	};
+	constexpr std::array<BotTypeLookupEntry, BotType_COUNT> _build_bot_type_lookup() {
+		std::array<BotTypeLookupEntry, BotType_COUNT> lookup = {};
+		for (unsigned int i = 0; i < BotType_COUNT; i++) {
+			lookup[i].lower_short_name = BOT_TYPE_INFO[i].lower_short_name.view();
+			lookup[i].type = BOT_TYPE_INFO[i].type;
+		}
+
+		// Insertion sort, the list is small and this only runs at compile time.
+		for (size_t i = 1; i < lookup.size(); i++) {
+			for (size_t j = i; j > 0 && lookup[j].lower_short_name < lookup[j - 1].lower_short_name; j--) {
+				BotTypeLookupEntry tmp = lookup[j];
+				lookup[j] = lookup[j - 1];
+				lookup[j - 1] = tmp;
+			}
+		}
+		return lookup;
+	}
+	constexpr std::array<BotTypeLookupEntry, BotType_COUNT> BOT_TYPE_LOOKUP = _build_bot_type_lookup();
+
+	// Case insensitive compare of key against an already lowercase name (<0, 0, >0 like strcmp).
+	constexpr int _compare_bot_type_name(std::string_view key, std::string_view lower_name) {
+		size_t count = key.size() < lower_name.size() ? key.size() : lower_name.size();
+		for (size_t i = 0; i < count; i++) {
+			char c = bot_type_to_lower(key[i]);
+			if (c != lower_name[i]) { return c < lower_name[i] ? -1 : 1; }
+		}
+		if (key.size() == lower_name.size()) { return 0; }
+		return key.size() < lower_name.size() ? -1 : 1;
+	}
+
+	constexpr const BotTypeInfo &get_bot_type_info(BotType type) {
+		return BOT_TYPE_INFO[type < BotType_COUNT ? type : BotType_None];
+	}
+
+	// Accepts both "Horde" and "BotType_Horde" in any casing. Returns BotType_COUNT if unknown.
+	constexpr BotType find_bot_type(std::string_view key) {
+
+		if (key.size() >= BOT_TYPE_PREFIX.size() && _compare_bot_type_name(key.substr(0, BOT_TYPE_PREFIX.size()), BOT_TYPE_PREFIX) == 0) {
+			key.remove_prefix(BOT_TYPE_PREFIX.size());
+		}
+
+		size_t low = 0;
+		size_t high = BOT_TYPE_LOOKUP.size();
+		while (low < high) {
+			size_t mid = low + (high - low) / 2;
+			int compare = _compare_bot_type_name(key, BOT_TYPE_LOOKUP[mid].lower_short_name);
+
+			if (compare == 0) { return BOT_TYPE_LOOKUP[mid].type; }
+			if (compare < 0) { high = mid; } else { low = mid + 1; }
+		}
+
+		return BotType_COUNT;
+	}
+	static_assert(find_bot_type("BotType_None") == BotType_None, "BotType lookup is broken.");
+	static_assert(find_bot_type("bogus") == BotType_COUNT, "BotType lookup is broken.");
+}
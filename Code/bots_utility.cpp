@@ -102,26 +102,22 @@ namespace bots {
         return true;
     }
     double get_current_path_length(Agent &agent) {
-
-        if (agent.bot_state.movement.path.empty()) { return 0; }
-        std::vector<V3> &path = agent.bot_state.movement.path;
-
-        double length_squared = (path.back() - agent.battle_state.position).length_squared();
-
-        for (int i = 0; i < path.size() - 1; i++) {
-            V3 &from = path[i];
-            V3 &to = path[i + 1];
-
-            length_squared += (from - to).length_squared();
-        }
-
-        return sqrt(length_squared);
+        return get_remaining_path_length(agent.bot_state.movement, agent.battle_state.position);
     }
 
+    bool add_hit_target(AttackDef &attack_def, int agent_id) {
+        return attack_def.hit_targets.insert(agent_id);
+    }
+    bool has_hit_target(const AttackDef &attack_def, int agent_id) {
+        return attack_def.hit_targets.contains(agent_id);
+    }
+    void clear_hit_targets(AttackDef &attack_def) {
+        attack_def.hit_targets.clear();
+    }
     void set_attack_on_cooldown(AttackDef &attack_def) {
         double cd = 0;
         if (attack_def.cooldown_max && attack_def.cooldown_min) {
-            cd = attack_def.cooldown_min + randomizer.rand(attack_def.cooldown_max - attack_def.cooldown_min);
+            cd = attack_def.cooldown_min + bot_rand(attack_def.cooldown_max - attack_def.cooldown_min);
         } else if (attack_def.cooldown_max) {
             cd = attack_def.cooldown_max;
         } else if (attack_def.cooldown_min) {
@@ -129,6 +125,25 @@ namespace bots {
         }
         attack_def.available_time = timing::elapsed_time_seconds + cd;
         attack_def.attack_state = AttackState::Prepare;
+
+        // Attacks that have a ready bit are kept in sync with the timer wheel, whichever overload put them on cooldown.
+        // Scheduling is the only place that writes ready_ticks, so the bit always tracks this available_time.
+        if (!timer_wheel_cooldowns || attack_def.ready_bit == BOT_NO_READY_BIT) { return; }
+
+        Agent *owner = gamestate::get_agent_by_id(netserver::state, attack_def.ready_owner_id);
+        if (!owner || !owner->is_bot_server) { return; }
+
+        const BotAttackCooldowns &cooldowns = owner->bot_state.attack_cooldowns;
+        if (attack_def.ready_bit < cooldowns.attack_count && cooldowns.attacks[attack_def.ready_bit] == &attack_def) {
+            schedule_attack_ready(*owner, attack_def.ready_bit, attack_def.available_time);
+        }
+    }
+    void set_attack_on_cooldown(Agent &agent, AttackDef &attack_def) {
+
+        if (timer_wheel_cooldowns) {
+            get_attack_ready_bit(agent, attack_def);
+        }
+        set_attack_on_cooldown(attack_def);
     }
     bool attack_off_cooldown(Agent &agent, AttackDef &attack_def, bool ignore_global_cooldown) {
 
@@ -138,6 +153,12 @@ namespace bots {
             if (elapsed_since_attack < agent.bot_state.global_action_cooldown) { return false; }
         }
 
+        // Attacks put on cooldown thru the timer wheel only need their ready bit checked.
+        const BotAttackCooldowns &cooldowns = agent.bot_state.attack_cooldowns;
+        if (timer_wheel_cooldowns && attack_def.ready_bit < cooldowns.attack_count && cooldowns.attacks[attack_def.ready_bit] == &attack_def) {
+            return cooldowns.ready_mask & (1u << attack_def.ready_bit);
+        }
+
         return timing::elapsed_time_seconds > attack_def.available_time;
     }
     bool within_attack_range(const AttackDef &attack_def, const double distance) {
@@ -6,6 +6,8 @@ namespace bots {
 
     struct BotState;
 
+    const size_t BOT_INLINE_HIT_TARGET_WORDS = 8; // Agent ids below 512 go into the bitset, higher ones into a short overflow list.
+
     // Used when Attacks contain animation chaining to keep track of the state of the Action / Attack.
     enum AttackState {
         Windup = 1,
@@ -41,14 +43,23 @@ namespace bots {
         double activation_time = 0.0;
         double available_time = 0.0;
         double last_attack_time = 0.0;
+        unsigned char ready_bit = BOT_NO_READY_BIT;   // Bit in BotAttackCooldowns::ready_mask, assigned by set_attack_on_cooldown(agent, attack).
+        unsigned int ready_owner_id = 0;                // Agent whose BotAttackCooldowns ready_bit belongs to.
         V3 target_position;
-        std::vector<int> hit_targets;
+        HitSet<BOT_INLINE_HIT_TARGET_WORDS> hit_targets;    // Agents hit during the current swing, see add_hit_target().
     };
 
     double get_dot_towards_position(Agent &agent, const V3 &position, bool ignore_pitch = false);
     double get_health_percentage_normalized(Agent &agent);
     double get_current_path_length(Agent &agent);
-    void set_attack_on_cooldown(AttackDef &attack_def);
+    // Returns false if the agent was already hit this swing.
+    bool add_hit_target(AttackDef &attack_def, int agent_id);
+    bool has_hit_target(const AttackDef &attack_def, int agent_id);
+    void clear_hit_targets(AttackDef &attack_def);    // O(1), call when a new swing starts.
+    void set_attack_on_cooldown(AttackDef &attack_def);                 // Schedules the expiry on the timer wheel if the attack has a ready bit.
+    void set_attack_on_cooldown(Agent &agent, AttackDef &attack_def);   // Also assigns the ready bit when timer_wheel_cooldowns is on.
+    // Attacks with a ready bit come off cooldown on the first timer wheel tick (1/30 s) at or after available_time,
+    // instead of the first frame after it, all others compare against available_time.
     bool attack_off_cooldown(Agent &agent, AttackDef &attack_def, bool ignore_global_cooldown = false);
     bool within_attack_range(const AttackDef &attack_def, const double distance);
     bool is_health_over_percentage(Agent &agent, float percentage);
@@ -0,0 +1,66 @@
+#include "bots.h"
+
+namespace bots {
+
+	bool warm_bot_pool_enabled = false;
+
+	WarmBotStatePool &get_warm_bot_state_pool() {
+		static WarmBotStatePool pool;
+		return pool;
+	}
+
+	void prewarm_bot_states(BotType type, size_t count) {
+
+		BotDefinition *bot_def = get_bot_definition(type);
+		if (!bot_def) { return; }
+
+		std::vector<BotState> &states = get_warm_bot_state_pool().states[type];
+		states.reserve(count);
+
+		while (states.size() < count) {
+			BotState &bot_state = states.emplace_back();
+			bot_state.type = type;
+			bot_state.movement.path.reserve(BOT_RESERVED_PATH_WAYPOINTS);
+			apply_bot_definition_to_bot_state(bot_state, *bot_def);
+			bot_state.warm_type = type;
+		}
+	}
+	bool take_warm_bot_state(Agent &agent) {
+
+		WarmBotStatePool &pool = get_warm_bot_state_pool();
+		BotState &bot_state = agent.bot_state;
+		const BotType type = bot_state.type;
+
+		if (type >= BotType_COUNT) { return false; }
+
+		// Recycled agents often respawn as the type they already were.
+		if (bot_state.warm_type == type) {
+			pool.warm_spawns++;
+			return true;
+		}
+
+		std::vector<BotState> &states = pool.states[type];
+		if (states.empty()) {
+			// Nothing pooled, the agent's own state is used and belongs to this type from now on.
+			bot_state.warm_type = type;
+			pool.cold_spawns++;
+			return false;
+		}
+
+		// The parked state must not linger in the DormantBotIndex under this agent's id.
+		wake_bot(agent);
+
+		std::swap(bot_state, states.back());
+		BotState parked = std::move(states.back());
+		states.pop_back();
+
+		// Park the previous state for the type it was spawned as, so a later spawn of that type can use it.
+		if (parked.warm_type < BotType_COUNT) {
+			pool.states[parked.warm_type].push_back(std::move(parked));
+		}
+
+		bot_state.type = type;
+		pool.warm_spawns++;
+		return true;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+struct Agent;
+
+namespace bots {
+
+    struct BotState;
+
+    // Recycled BotStates per BotType. A spawn swaps the agent's previous BotState into the pool of its old type and
+    // takes one that was already used by the new type, keeping its container capacity.
+    // This only helps when an agent respawns as another BotType. An agent respawning as the same type keeps its own
+    // BotState, and with it its container capacity, with or without the pool. It does not make spawning cheaper
+    // otherwise: the definition is applied in full and battle callbacks are deliberately cleared and rebound on
+    // every spawn, so the previous life's script state can't leak into the new one.
+    struct WarmBotStatePool {
+        std::vector<BotState> states[BotType_COUNT];
+        unsigned long long warm_spawns = 0;
+        unsigned long long cold_spawns = 0;
+    };
+
+    // Enables spawning from the warm pool in initialize_bot_state_by_type, see WarmBotStatePool for when that pays off.
+    extern bool warm_bot_pool_enabled;
+
+    WarmBotStatePool &get_warm_bot_state_pool();
+
+    // Fills the pool of a type up to count states, e.g. when a wave is set up.
+    void prewarm_bot_states(BotType type, size_t count);
+
+    // Returns true if the agent's BotState was swapped for a warm one of its type.
+    bool take_warm_bot_state(Agent &agent);
+}